@@ -0,0 +1,272 @@
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+#include <climits>
+
+#ifndef CPP_EX3_AHOCORASICK_HPP
+#define CPP_EX3_AHOCORASICK_HPP
+
+#define ALPHABET_SIZE 256
+
+#define EMPTY_PATTERN "Patterns must not be empty"
+
+#define TOO_MANY_STATES "The patterns need more than 2^32 - 1 states"
+
+/**
+ * @brief Aho-Corasick automaton scoring a text against a fixed set of weighted patterns in
+ * a single pass. Every occurrence of every pattern adds the pattern's weight, overlapping
+ * occurrences included, the same total as calling std::string::find for each pattern at
+ * every position.
+ * The trie states are numbered in breadth first order, so the edges of a state are
+ * contiguous, sorted by byte, and edge i always leads to state i + 1: an edge takes one
+ * byte and states need no child pointers. Each state also keeps its failure link and the
+ * total weight of the patterns ending at it or at any state on its failure chain, so a
+ * text position costs one transition and one addition. The root keeps a full table.
+ * Patterns of weight 0 can't change any score, so they get no states.
+ * Matching may ignore the case of ASCII letters, through a table folding every byte of
+ * the patterns and of the text as it is read, so no lowercase copy of a text is needed.
+ */
+class AhoCorasick
+{
+private:
+    /**
+     * @brief Edges of state i are firstEdge[i] to firstEdge[i + 1], one more than states.
+     */
+    std::vector<uint32_t> firstEdge;
+
+    /**
+     * @brief Byte of every edge, edge i leads to state i + 1.
+     */
+    std::vector<unsigned char> edgeByte;
+
+    /**
+     * @brief Failure link of every state, the state of its longest proper suffix in the trie.
+     */
+    std::vector<uint32_t> fail;
+
+    /**
+     * @brief Total weight of the patterns that end when the automaton enters each state.
+     */
+    std::vector<long long> output;
+
+    /**
+     * @brief Transitions of the root, 0 for bytes no pattern starts with.
+     */
+    uint32_t rootNext[ALPHABET_SIZE];
+
+    /**
+     * @brief Byte every byte of patterns and texts is read as.
+     */
+    unsigned char fold[ALPHABET_SIZE];
+
+    /**
+     * @brief Builds the trie, the failure links and the outputs.
+     * @param patterns pointers to non empty patterns and their weights, sorted by their
+     * folded bytes.
+     */
+    void _build(const std::vector<std::pair<const std::string *, long long>> &patterns);
+
+    /**
+     * @brief Follows one byte, taking failure links until a state has an edge for it.
+     * @param state current state.
+     * @param c byte read.
+     * @return next state.
+     */
+    uint32_t _next(uint32_t state, unsigned char c) const
+    {
+        while (state != 0)
+        {
+            uint32_t first = firstEdge[state];
+            const void *edge = memchr(edgeByte.data() + first, c, firstEdge[state + 1] - first);
+            if (edge != nullptr)
+            {
+                return (uint32_t) ((const unsigned char *) edge - edgeByte.data()) + 1;
+            }
+            state = fail[state];
+        }
+        return rootNext[c];
+    }
+
+public:
+    /**
+     * @brief Builds the automaton of all the pairs of a map.
+     * @param patterns map of non empty std::string keys to integer weights, such as a
+     * HashMap or an OrderedHashMap.
+     * @param ignoreCase true to match ASCII letters regardless of their case, as comparing
+     * after std::tolower in the "C" locale does. Patterns equal but for case then add up.
+     */
+    template<class Map>
+    explicit AhoCorasick(const Map &patterns, bool ignoreCase = false);
+
+    /**
+     * @return number of states of the automaton.
+     */
+    size_t numOfStates() const
+    {
+        return fail.size();
+    }
+
+    /**
+     * @brief Scores a text.
+     * @param text text to search the patterns in.
+     * @return sum of the weights of all the occurrences of patterns in text.
+     */
+    long long score(const std::string &text) const
+    {
+        uint32_t state = 0;
+        return score(text.data(), text.size(), state);
+    }
+
+    /**
+     * @brief Scores one piece of a longer text, occurrences spanning the end of the
+     * previous piece included.
+     * @param text bytes of the piece.
+     * @param length number of bytes in the piece.
+     * @param state state the previous piece left, 0 before the first piece, set to the
+     * state to continue from with the next piece.
+     * @param limit the scan stops as soon as the sum reaches it, which with non negative
+     * weights is enough to tell that the full score reaches it too.
+     * @return sum of the weights of the occurrences of patterns ending in this piece, or
+     * in the part of it scanned before the sum reached limit.
+     */
+    long long score(const char *text, size_t length, uint32_t &state, long long limit = LLONG_MAX) const;
+};
+
+/**
+ * @brief Builds the automaton of all the pairs of a map.
+ * @param patterns map of non empty std::string keys to integer weights, such as a
+ * HashMap or an OrderedHashMap.
+ * @param ignoreCase true to match ASCII letters regardless of their case, as comparing
+ * after std::tolower in the "C" locale does. Patterns equal but for case then add up.
+ */
+template<class Map>
+AhoCorasick::AhoCorasick(const Map &patterns, bool ignoreCase)
+{
+    for (int c = 0; c < ALPHABET_SIZE; c++)
+    {
+        fold[c] = (unsigned char) (ignoreCase && c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+    }
+    std::vector<std::pair<const std::string *, long long>> sorted;
+    sorted.reserve(patterns.size());
+    for (const auto &pair: patterns)
+    {
+        if (pair.first.empty())
+        {
+            throw std::invalid_argument(EMPTY_PATTERN);
+        }
+        if (pair.second != 0)
+        {
+            sorted.emplace_back(&pair.first, (long long) pair.second);
+        }
+    }
+    std::sort(sorted.begin(), sorted.end(),
+              [this](const std::pair<const std::string *, long long> &a, const std::pair<const std::string *, long long> &b)
+              {
+                  return std::lexicographical_compare(a.first->begin(), a.first->end(), b.first->begin(), b.first->end(),
+                                                      [this](char x, char y)
+                                                      { return fold[(unsigned char) x] < fold[(unsigned char) y]; });
+              });
+    _build(sorted);
+}
+
+/**
+ * @brief Builds the trie, the failure links and the outputs.
+ * The states of one depth are made together: the patterns under a state are a range of
+ * the sorted patterns, and its children split that range by the next byte, so going over
+ * the states of a depth in order makes the states of the next depth in breadth first order.
+ * @param patterns pointers to non empty patterns and their weights, sorted by their
+ * folded bytes.
+ */
+inline void AhoCorasick::_build(const std::vector<std::pair<const std::string *, long long>> &patterns)
+{
+    std::vector<std::pair<size_t, size_t>> level(1, std::make_pair((size_t) 0, patterns.size()));
+    std::vector<std::pair<size_t, size_t>> nextLevel;
+    output.push_back(0);
+    for (size_t depth = 0; !level.empty(); depth++)
+    {
+        nextLevel.clear();
+        for (const std::pair<size_t, size_t> &range: level)
+        {
+            firstEdge.push_back((uint32_t) edgeByte.size());
+            // The patterns ending at this state come first in its range.
+            size_t i = range.first;
+            while (i < range.second && patterns[i].first->size() == depth)
+            {
+                i++;
+            }
+            while (i < range.second)
+            {
+                unsigned char c = fold[(unsigned char) (*patterns[i].first)[depth]];
+                long long weight = 0;
+                size_t end = i;
+                while (end < range.second && fold[(unsigned char) (*patterns[end].first)[depth]] == c)
+                {
+                    if (patterns[end].first->size() == depth + 1)
+                    {
+                        weight += patterns[end].second;
+                    }
+                    end++;
+                }
+                if (edgeByte.size() >= UINT32_MAX - 1)
+                {
+                    throw std::length_error(TOO_MANY_STATES);
+                }
+                edgeByte.push_back(c);
+                output.push_back(weight);
+                nextLevel.emplace_back(i, end);
+                i = end;
+            }
+        }
+        level.swap(nextLevel);
+    }
+    firstEdge.push_back((uint32_t) edgeByte.size());
+
+    std::fill(rootNext, rootNext + ALPHABET_SIZE, 0);
+    fail.assign(output.size(), 0);
+    for (uint32_t edge = firstEdge[0]; edge < firstEdge[1]; edge++)
+    {
+        rootNext[edgeByte[edge]] = edge + 1;
+    }
+    // Parents come before their children, and failure links lead to shallower states.
+    for (uint32_t state = 1; state < fail.size(); state++)
+    {
+        for (uint32_t edge = firstEdge[state]; edge < firstEdge[state + 1]; edge++)
+        {
+            uint32_t child = edge + 1;
+            fail[child] = _next(fail[state], edgeByte[edge]);
+            output[child] += output[fail[child]];
+        }
+    }
+}
+
+/**
+ * @brief Scores one piece of a longer text, occurrences spanning the end of the
+ * previous piece included.
+ * @param text bytes of the piece.
+ * @param length number of bytes in the piece.
+ * @param state state the previous piece left, 0 before the first piece, set to the
+ * state to continue from with the next piece.
+ * @param limit the scan stops as soon as the sum reaches it, which with non negative
+ * weights is enough to tell that the full score reaches it too.
+ * @return sum of the weights of the occurrences of patterns ending in this piece, or
+ * in the part of it scanned before the sum reached limit.
+ */
+inline long long AhoCorasick::score(const char *text, size_t length, uint32_t &state, long long limit) const
+{
+    long long total = 0;
+    uint32_t current = state;
+    for (size_t i = 0; i < length && total < limit; i++)
+    {
+        current = _next(current, fold[(unsigned char) text[i]]);
+        total += output[current];
+    }
+    state = current;
+    return total;
+}
+
+
+#endif //CPP_EX3_AHOCORASICK_HPP
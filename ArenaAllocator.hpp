@@ -0,0 +1,220 @@
+#include <cstddef>
+#include <new>
+#include <vector>
+
+#ifndef CPP_EX3_ARENAALLOCATOR_HPP
+#define CPP_EX3_ARENAALLOCATOR_HPP
+
+#define DEFAULT_CHUNK_SIZE (64 * 1024)
+
+#define MIN_BLOCK_SIZE 16
+
+#define NUM_OF_SIZE_CLASSES 64
+
+/**
+ * @brief Pool of memory chunks handing out blocks by bumping a pointer.
+ * Freed blocks are kept in free lists by power of two size class and reused by later
+ * allocations of the same class, so tables that grow and shrink don't go back to the heap.
+ * All chunks are returned to the heap at once by release() or by the destructor.
+ * An Arena isn't thread safe, use one per thread (or per HashMap).
+ */
+class Arena
+{
+private:
+    /**
+     * @brief Header of a freed block, links it to the next free block of its size class.
+     */
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    /**
+     * @brief Every chunk taken from the heap.
+     */
+    std::vector<char *> chunks;
+
+    /**
+     * @brief Next free byte in the current chunk and the byte past its end.
+     */
+    char *top, *limit;
+
+    /**
+     * @brief Size of a regular chunk.
+     */
+    size_t chunkSize;
+
+    /**
+     * @brief Heads of the free block lists, one per size class.
+     */
+    FreeBlock *freeLists[NUM_OF_SIZE_CLASSES];
+
+    /**
+     * @param bytes requested size.
+     * @return size class of a block of at least bytes bytes, blocks of class c are 2^c bytes.
+     */
+    static int _sizeClass(size_t bytes)
+    {
+        int sizeClass = 0;
+        while (((size_t) 1 << sizeClass) < bytes || ((size_t) 1 << sizeClass) < MIN_BLOCK_SIZE)
+        {
+            sizeClass++;
+        }
+        return sizeClass;
+    }
+
+public:
+    /**
+     * @brief Arena constructor, takes no memory until the first allocation.
+     * @param chunk size of each chunk taken from the heap.
+     */
+    explicit Arena(size_t chunk = DEFAULT_CHUNK_SIZE) :
+            top(nullptr), limit(nullptr), chunkSize(chunk), freeLists()
+    {
+    }
+
+    Arena(const Arena &other) = delete;
+
+    Arena &operator=(const Arena &other) = delete;
+
+    /**
+     * @brief Arena destructor, returns all chunks to the heap.
+     */
+    ~Arena()
+    {
+        release();
+    }
+
+    /**
+     * @brief Hands out a block of memory.
+     * @param bytes size of the block.
+     * @param alignment required alignment of the block, at most alignof(std::max_align_t).
+     * @return pointer to the block.
+     */
+    void *allocate(size_t bytes, size_t alignment)
+    {
+        int sizeClass = _sizeClass(bytes);
+        if (freeLists[sizeClass] != nullptr)
+        {
+            FreeBlock *block = freeLists[sizeClass];
+            freeLists[sizeClass] = block->next;
+            return block;
+        }
+        size_t blockSize = (size_t) 1 << sizeClass;
+        size_t padding = (alignment - (size_t) top % alignment) % alignment;
+        if (top == nullptr || (size_t) (limit - top) < padding + blockSize)
+        {
+            size_t size = blockSize > chunkSize ? blockSize : chunkSize;
+            chunks.push_back(static_cast<char *>(::operator new(size)));
+            top = chunks.back();
+            limit = top + size;
+            padding = 0;
+        }
+        void *block = top + padding;
+        top += padding + blockSize;
+        return block;
+    }
+
+    /**
+     * @brief Gives a block back to the Arena for reuse, the memory stays in the Arena.
+     * @param block pointer returned by allocate.
+     * @param bytes size the block was allocated with.
+     */
+    void deallocate(void *block, size_t bytes)
+    {
+        int sizeClass = _sizeClass(bytes);
+        FreeBlock *freed = static_cast<FreeBlock *>(block);
+        freed->next = freeLists[sizeClass];
+        freeLists[sizeClass] = freed;
+    }
+
+    /**
+     * @brief Returns every chunk to the heap at once, invalidating all blocks.
+     */
+    void release()
+    {
+        for (char *chunk: chunks)
+        {
+            ::operator delete(chunk);
+        }
+        chunks.clear();
+        top = limit = nullptr;
+        for (FreeBlock *&list: freeLists)
+        {
+            list = nullptr;
+        }
+    }
+};
+
+/**
+ * @brief Standard allocator handing out memory from an Arena, may be passed to HashMap so
+ * all of its tables are taken from the Arena.
+ * @tparam T type of objects to allocate.
+ */
+template<class T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+
+    /**
+     * @brief Arena all copies of this allocator take memory from.
+     */
+    Arena *arena;
+
+    /**
+     * @brief ArenaAllocator constructor.
+     * @param source Arena to take memory from, must outlive the allocator.
+     */
+    explicit ArenaAllocator(Arena &source) : arena(&source)
+    {
+    }
+
+    /**
+     * @brief Converting constructor, used by containers to allocate other types.
+     * @param other allocator of another type sharing the Arena.
+     */
+    template<class U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena)
+    {
+    }
+
+    /**
+     * @param n number of objects.
+     * @return pointer to memory for n objects of type T.
+     */
+    T *allocate(size_t n)
+    {
+        return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    /**
+     * @param p pointer returned by allocate.
+     * @param n number of objects p was allocated for.
+     */
+    void deallocate(T *p, size_t n)
+    {
+        arena->deallocate(p, n * sizeof(T));
+    }
+
+    /**
+     * @return true if both allocators take memory from the same Arena.
+     */
+    template<class U>
+    bool operator==(const ArenaAllocator<U> &other) const
+    {
+        return arena == other.arena;
+    }
+
+    /**
+     * @return true if the allocators take memory from different Arenas.
+     */
+    template<class U>
+    bool operator!=(const ArenaAllocator<U> &other) const
+    {
+        return arena != other.arena;
+    }
+};
+
+
+#endif //CPP_EX3_ARENAALLOCATOR_HPP
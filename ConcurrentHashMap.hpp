@@ -0,0 +1,262 @@
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <functional>
+#include <stdexcept>
+#include <cstdint>
+#include "HashMap.hpp"
+
+#ifndef CPP_EX3_CONCURRENTHASHMAP_HPP
+#define CPP_EX3_CONCURRENTHASHMAP_HPP
+
+#define DEFAULT_NUM_OF_SHARDS 64
+
+#define CACHE_LINE_SIZE 64
+
+/**
+ * @brief Thread safe HashMap splitting its keys between independently locked shards.
+ * Every shard is a HashMap guarded by its own reader-writer lock, so readers of a shard
+ * don't block each other, writers only block their own shard, and a shard growing or
+ * shrinking only stops the threads working on that shard.
+ * Values are returned by copy, no reference into a shard escapes its lock.
+ * @tparam KeyT Objects to search ValueT by.
+ * @tparam ValueT Object to hold.
+ * @tparam Hash hash of KeyT objects, used to pick a shard and by the shards' HashMaps.
+ * @tparam KeyEqual equality of KeyT objects.
+ */
+template<class KeyT, class ValueT, class Hash = DefaultHash<KeyT>, class KeyEqual = DefaultEqual<KeyT>>
+class ConcurrentHashMap
+{
+private:
+    /**
+     * @brief A HashMap and the lock guarding it, kept on its own cache lines.
+     */
+    struct alignas(CACHE_LINE_SIZE) Shard
+    {
+        mutable std::shared_mutex lock;
+        HashMap<KeyT, ValueT, Hash, KeyEqual> map;
+    };
+
+    typedef std::shared_lock<std::shared_mutex> readLock;
+
+    typedef std::unique_lock<std::shared_mutex> writeLock;
+
+    /**
+     * @brief Number of shards, a power of two.
+     */
+    int numOfShards;
+
+    /**
+     * @brief Number of bits in a shard index.
+     */
+    int shardBits;
+
+    /**
+     * @brief Array of numOfShards shards.
+     */
+    std::unique_ptr<Shard[]> shards;
+
+    /**
+     * @brief Hash of keys picking their shard.
+     */
+    Hash hasher;
+
+    /**
+     * @param key to locate.
+     * @return shard responsible for key. The top bits of a multiplicative hash are used, so
+     * the shards' own HashMaps still see well spread hashes.
+     */
+    Shard &_shard(const KeyT &key) const
+    {
+        if (shardBits == 0)
+        {
+            return shards[0];
+        }
+        uint64_t hash = (uint64_t) hasher(key) * GOLDEN_RATIO_64;
+        return shards[(size_t) (hash >> (64 - shardBits))];
+    }
+
+public:
+    /**
+     * @brief ConcurrentHashMap constructor.
+     * @param shardCount minimal number of shards, rounded up to a power of two. Should be
+     * a few times the number of threads using the map.
+     */
+    explicit ConcurrentHashMap(int shardCount = DEFAULT_NUM_OF_SHARDS) :
+            numOfShards(1), shardBits(0)
+    {
+        while (numOfShards < shardCount)
+        {
+            numOfShards *= 2;
+            shardBits++;
+        }
+        shards.reset(new Shard[numOfShards]);
+    }
+
+    ConcurrentHashMap(const ConcurrentHashMap &other) = delete;
+
+    ConcurrentHashMap &operator=(const ConcurrentHashMap &other) = delete;
+
+    /**
+     * @return number of shards.
+     */
+    int shardCount() const
+    {
+        return numOfShards;
+    }
+
+    /**
+     * @brief counts the items in all shards, each shard is read at a different moment.
+     * @return number of items in the map.
+     */
+    size_t size() const
+    {
+        size_t count = 0;
+        for (int i = 0; i < numOfShards; i++)
+        {
+            readLock guard(shards[i].lock);
+            count += shards[i].map.size();
+        }
+        return count;
+    }
+
+    /**
+     * @return true if no shard holds an item.
+     */
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /**
+     * @brief inserts a new value if key isn't in the map.
+     * @param key to locate value by.
+     * @param val value to input.
+     * @return true if insertion was successful, false if key was already in the map.
+     */
+    bool insert(const KeyT &key, const ValueT &val)
+    {
+        Shard &shard = _shard(key);
+        writeLock guard(shard.lock);
+        return shard.map.insert(key, val);
+    }
+
+    /**
+     * @brief inserts a new value, or replaces the value of key if it is already in the map.
+     * @param key to locate value by.
+     * @param val value to input.
+     * @return true if key was inserted, false if an existing value was replaced.
+     */
+    bool insert_or_assign(const KeyT &key, const ValueT &val)
+    {
+        Shard &shard = _shard(key);
+        writeLock guard(shard.lock);
+        size_t before = shard.map.size();
+        shard.map[key] = val;
+        return shard.map.size() > before;
+    }
+
+    /**
+     * @brief Atomically updates the value of key, inserting a default ValueT first if key
+     * isn't in the map. No other thread sees the value between the insertion and the update.
+     * @param key to locate value by.
+     * @param update called with a reference to the value, must not access this map.
+     * @return true if key was inserted, false if it was already in the map.
+     */
+    template<class Function>
+    bool upsert(const KeyT &key, Function update)
+    {
+        Shard &shard = _shard(key);
+        writeLock guard(shard.lock);
+        size_t before = shard.map.size();
+        update(shard.map[key]);
+        return shard.map.size() > before;
+    }
+
+    /**
+     * @brief checks if a given key is contained in the map.
+     * @param key the key to search for.
+     * @return true if the map contains the key, false otherwise.
+     */
+    bool containsKey(const KeyT &key) const
+    {
+        Shard &shard = _shard(key);
+        readLock guard(shard.lock);
+        return shard.map.containsKey(key);
+    }
+
+    /**
+     * @brief Get value by key.
+     * @param key to search by.
+     * @return copy of the value if the map contains key, throws exception otherwise.
+     */
+    ValueT at(const KeyT &key) const
+    {
+        Shard &shard = _shard(key);
+        readLock guard(shard.lock);
+        return shard.map.at(key);
+    }
+
+    /**
+     * @brief Get value by key without throwing.
+     * @param key to search by.
+     * @param val set to a copy of the value if the map contains key.
+     * @return true if the map contains key, false otherwise.
+     */
+    bool find(const KeyT &key, ValueT &val) const
+    {
+        Shard &shard = _shard(key);
+        readLock guard(shard.lock);
+        auto place = shard.map.find(key);
+        if (place == shard.map.end())
+        {
+            return false;
+        }
+        val = place->second;
+        return true;
+    }
+
+    /**
+     * @brief Erases key and value from the map.
+     * @param key to erase.
+     * @return true if erasure was successful, false otherwise.
+     */
+    bool erase(const KeyT &key)
+    {
+        Shard &shard = _shard(key);
+        writeLock guard(shard.lock);
+        return shard.map.erase(key);
+    }
+
+    /**
+     * @brief clears all items, one shard at a time.
+     */
+    void clear()
+    {
+        for (int i = 0; i < numOfShards; i++)
+        {
+            writeLock guard(shards[i].lock);
+            shards[i].map.clear();
+        }
+    }
+
+    /**
+     * @brief Calls visit on every pair, holding the read lock of one shard at a time.
+     * @param visit called with a const reference to every pair, must not access this map.
+     */
+    template<class Function>
+    void forEach(Function visit) const
+    {
+        for (int i = 0; i < numOfShards; i++)
+        {
+            readLock guard(shards[i].lock);
+            for (const auto &pair: shards[i].map)
+            {
+                visit(pair);
+            }
+        }
+    }
+};
+
+
+#endif //CPP_EX3_CONCURRENTHASHMAP_HPP
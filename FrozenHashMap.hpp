@@ -0,0 +1,571 @@
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <initializer_list>
+#include <algorithm>
+#include <cstdint>
+#include "HashMap.hpp"
+
+#ifndef CPP_EX3_FROZENHASHMAP_HPP
+#define CPP_EX3_FROZENHASHMAP_HPP
+
+#define FROZEN_BUCKET_SIZE 4
+
+#define FROZEN_LOAD_FACTOR 0.98
+
+#define FROZEN_MAX_PILOT 65536
+
+#define FROZEN_DENSE_KEYS 0.6
+
+#define FROZEN_DENSE_BUCKETS 0.3
+
+#define EQUAL_HASHES "Two keys have equal hashes and can't be perfectly hashed"
+
+/**
+ * @brief Immutable map built once from a fixed set of pairs with a minimal perfect hash
+ * (hash and displace, as in CHD and PTHash). Keys are split into buckets of about
+ * FROZEN_BUCKET_SIZE keys by their hash, and every bucket gets a pilot number chosen at
+ * build time so that hashing each key together with its bucket's pilot sends all keys to
+ * distinct positions. There are a few more positions than keys, FROZEN_LOAD_FACTOR of them
+ * used, so the last buckets still find free positions after a few pilots. The keys sent
+ * past the last slot are moved to the slots left free, and a small remap array says where.
+ * The slot array holds exactly one pair per key, and a lookup reads one pilot and compares
+ * one key, hits and misses alike.
+ * @tparam KeyT Objects to search ValueT by.
+ * @tparam ValueT Object to hold.
+ * @tparam Hash hash of KeyT objects, its result is mixed first unless it is avalanching.
+ * @tparam KeyEqual equality of KeyT objects, lookups are transparent as in HashMap.
+ */
+template<class KeyT, class ValueT, class Hash = DefaultHash<KeyT>, class KeyEqual = DefaultEqual<KeyT>>
+class FrozenHashMap
+{
+private:
+    typedef std::pair<KeyT, ValueT> pairType;
+
+    template<class, class, class, class> friend class MappedHashMap;
+
+    /**
+     * @brief One pair per key, in the slot the perfect hash sends the key to.
+     */
+    std::vector<pairType> slots;
+
+    /**
+     * @brief Pilot of every bucket.
+     */
+    std::vector<uint32_t> pilots;
+
+    /**
+     * @brief Slot of the key sent to every position past the last slot, 0 for positions no
+     * key is sent to.
+     */
+    std::vector<size_t> remap;
+
+    /**
+     * @brief Hash of keys.
+     */
+    Hash hasher;
+
+    /**
+     * @brief Equality of keys.
+     */
+    KeyEqual keyEqual;
+
+    /**
+     * @brief Enables the lookups taking other types than KeyT, only when both Hash and
+     * KeyEqual declare is_transparent.
+     */
+    template<class K>
+    using _transparent = typename std::enable_if<IsTransparent<Hash>::value && IsTransparent<KeyEqual>::value,
+            K>::type;
+
+    /**
+     * @param key KeyT object, or object Hash accepts if lookups are transparent, to hash.
+     * @return full hash of key, mixed the same way HashMap mixes it.
+     */
+    template<class K>
+    size_t _hash(const K &key) const
+    {
+        size_t hash = hasher(key);
+        return IsAvalanching<Hash>::value ? hash : IntegerHash()(hash);
+    }
+
+    /**
+     * @brief Maps a 64 bit number to [0, range) by its high bits, without a division.
+     * @param x number to map.
+     * @param range size of the range, positive.
+     * @return number between 0 and range.
+     */
+    static size_t _reduce(uint64_t x, size_t range)
+    {
+#ifdef __SIZEOF_INT128__
+        return (size_t) (((__uint128_t) x * range) >> 64);
+#else
+        return (size_t) (x % range);
+#endif
+    }
+
+    /**
+     * @param hash full hash of a key.
+     * @param numOfBuckets number of buckets, positive.
+     * @return bucket of the key. FROZEN_DENSE_KEYS of the keys go to the first
+     * FROZEN_DENSE_BUCKETS of the buckets, as in PTHash: the big buckets are placed while the
+     * positions are mostly free, and the rest are small enough to fit once they are not.
+     * The hash is mixed again first, hashes such as IntegerHash of consecutive keys are
+     * spread too evenly, which leaves every bucket the same size.
+     */
+    static size_t _bucket(size_t hash, size_t numOfBuckets)
+    {
+        uint64_t mixed = foldedMultiply(hash ^ WYHASH_SECRET_2, WYHASH_SECRET_3);
+        size_t dense = std::min(numOfBuckets, (size_t) ((double) numOfBuckets * FROZEN_DENSE_BUCKETS) + 1);
+        if (dense == numOfBuckets || mixed < (uint64_t) (FROZEN_DENSE_KEYS * 18446744073709551616.0))
+        {
+            return _reduce(mixed * GOLDEN_RATIO_64, dense);
+        }
+        return dense + _reduce(mixed * GOLDEN_RATIO_64, numOfBuckets - dense);
+    }
+
+    /**
+     * @param hash full hash of a key.
+     * @param pilot pilot of the key's bucket.
+     * @param numOfPositions number of positions, slots and remapped positions together.
+     * @return position the key is sent to with this pilot.
+     */
+    static size_t _position(size_t hash, uint32_t pilot, size_t numOfPositions)
+    {
+        return _reduce(foldedMultiply(hash ^ (GOLDEN_RATIO_64 * pilot), WYHASH_SECRET_1), numOfPositions);
+    }
+
+    /**
+     * @param hash full hash of a key.
+     * @param pilots pilot of every bucket.
+     * @param numOfBuckets number of buckets, positive.
+     * @param remap slot of every position past the last slot, size_t here and uint64_t in images.
+     * @param numOfRemapped number of positions past the last slot.
+     * @param numOfSlots number of slots.
+     * @return slot a key holding this hash would be in.
+     */
+    template<class Index>
+    static size_t _slot(size_t hash, const uint32_t *pilots, size_t numOfBuckets, const Index *remap,
+                        size_t numOfRemapped, size_t numOfSlots)
+    {
+        size_t place = _position(hash, pilots[_bucket(hash, numOfBuckets)], numOfSlots + numOfRemapped);
+        return place < numOfSlots ? place : (size_t) remap[place - numOfSlots];
+    }
+
+    /**
+     * @brief Looks for a key with a single probe.
+     * @param key KeyT object, or object KeyEqual compares to keys if lookups are transparent.
+     * @return index of the slot holding key, NO_SLOT if key isn't in the map.
+     */
+    template<class K>
+    size_t _locate(const K &key) const
+    {
+        if (slots.empty())
+        {
+            return NO_SLOT;
+        }
+        size_t place = _slot(_hash(key), pilots.data(), pilots.size(), remap.data(), remap.size(), slots.size());
+        return keyEqual(slots[place].first, key) ? place : NO_SLOT;
+    }
+
+    /**
+     * @brief Chooses the pilots and places the pairs.
+     * @param source pointers to the pairs to hold, with distinct keys.
+     */
+    void _build(const std::vector<const pairType *> &source);
+
+    /**
+     * @brief Chooses a pilot for every bucket, sending all keys to distinct positions.
+     * @param hashes hash of every key.
+     * @param byBucket keys ordered by bucket.
+     * @param bucketStart index in byBucket of the first key of every bucket, and one past the last.
+     * @param bySize buckets from the biggest to the smallest.
+     * @param numOfPositions number of positions to send the keys to, at least the number of keys.
+     * @param owner set to the key sent to every position, NO_SLOT for free positions.
+     * @return true if every bucket found a pilot below FROZEN_MAX_PILOT, false otherwise.
+     */
+    bool _placeBuckets(const std::vector<size_t> &hashes, const std::vector<size_t> &byBucket,
+                       const std::vector<size_t> &bucketStart, const std::vector<size_t> &bySize,
+                       size_t numOfPositions, std::vector<size_t> &owner);
+
+public:
+    typedef size_t size_type;
+
+    typedef typename std::vector<pairType>::const_iterator const_iterator;
+
+    /**
+     * @brief Builds a FrozenHashMap holding the pairs of a HashMap, using its hash and equality.
+     * @param source HashMap to copy.
+     */
+    template<class Alloc>
+    explicit FrozenHashMap(const HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &source);
+
+    /**
+     * @brief Constructor that receives values in two separate vectors, a later pair of a
+     * repeated key replaces the earlier one as in HashMap.
+     * @param keys const reference to KeyT object vector.
+     * @param values const reference to ValueT object vector.
+     */
+    FrozenHashMap(const std::vector<KeyT> &keys, const std::vector<ValueT> &values) :
+            FrozenHashMap(HashMap<KeyT, ValueT, Hash, KeyEqual>(keys, values))
+    {
+    }
+
+    /**
+     * @brief Builds a FrozenHashMap from a list of pairs, a later pair of a repeated key
+     * replaces the earlier one.
+     * @param list pairs to hold.
+     */
+    FrozenHashMap(std::initializer_list<pairType> list);
+
+    /**
+     * @return number of items in the map.
+     */
+    size_type size() const
+    {
+        return slots.size();
+    }
+
+    /**
+     * @return true if the map is empty.
+     */
+    bool empty() const
+    {
+        return slots.empty();
+    }
+
+    /**
+     * @brief checks if a given key is contained in the map.
+     * @param key the key to search for.
+     * @return true if the map contains the key, false otherwise.
+     */
+    bool containsKey(const KeyT &key) const
+    {
+        return _locate(key) != NO_SLOT;
+    }
+
+    /**
+     * @brief checks if a key given as another type is contained in the map, only when
+     * lookups are transparent.
+     * @param key object Hash accepts and KeyEqual compares to keys.
+     * @return true if the map contains the key, false otherwise.
+     */
+    template<class K, class = _transparent<K>>
+    bool containsKey(const K &key) const
+    {
+        return _locate(key) != NO_SLOT;
+    }
+
+    /**
+     * @brief Counts the pairs of a key.
+     * @param key the key to search for.
+     * @return 1 if the map contains the key, 0 otherwise.
+     */
+    size_type count(const KeyT &key) const
+    {
+        return _locate(key) != NO_SLOT ? 1 : 0;
+    }
+
+    /**
+     * @brief Get value by key.
+     * @param key to search by.
+     * @return reference to ValueT object if the map contains key, throws exception otherwise.
+     */
+    const ValueT &at(const KeyT &key) const;
+
+    /**
+     * @brief Get value by a key given as another type, only when lookups are transparent.
+     * @param key object Hash accepts and KeyEqual compares to keys.
+     * @return reference to ValueT object if the map contains key, throws exception otherwise.
+     */
+    template<class K, class = _transparent<K>>
+    const ValueT &at(const K &key) const
+    {
+        size_t place = _locate(key);
+        if (place == NO_SLOT)
+        {
+            throw std::out_of_range(KEY_DOES_NOT_EXIST);
+        }
+        return slots[place].second;
+    }
+
+    /**
+     * @brief Looks for a key without throwing.
+     * @param key to search for.
+     * @return A const iterator pointing to key's pair, end() if key isn't in the map.
+     */
+    const_iterator find(const KeyT &key) const
+    {
+        size_t place = _locate(key);
+        return place == NO_SLOT ? end() : slots.begin() + place;
+    }
+
+    /**
+     * @brief Looks for a key given as another type, only when lookups are transparent.
+     * @param key object Hash accepts and KeyEqual compares to keys.
+     * @return A const iterator pointing to key's pair, end() if key isn't in the map.
+     */
+    template<class K, class = _transparent<K>>
+    const_iterator find(const K &key) const
+    {
+        size_t place = _locate(key);
+        return place == NO_SLOT ? end() : slots.begin() + place;
+    }
+
+    /**
+     * @return A const iterator pointing to the first item in the map.
+     */
+    const_iterator begin() const
+    {
+        return slots.begin();
+    }
+
+    /**
+     * @return A const iterator pointing past the last item in the map.
+     */
+    const_iterator end() const
+    {
+        return slots.end();
+    }
+
+    /**
+     * @return A const iterator pointing to the first item in the map.
+     */
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+
+    /**
+     * @return A const iterator pointing past the last item in the map.
+     */
+    const_iterator cend() const
+    {
+        return end();
+    }
+
+    /**
+     * @brief [] operator overload when <FrozenHashMap_name>[KeyT key] is called.
+     * @return the ValueT item in the key place if it exists, a default ValueT otherwise.
+     */
+    ValueT operator[](const KeyT &key) const
+    {
+        size_t place = _locate(key);
+        return place == NO_SLOT ? ValueT() : slots[place].second;
+    }
+};
+
+/**
+ * @brief Builds a FrozenHashMap holding the pairs of a HashMap, using its hash and equality.
+ * @param source HashMap to copy.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+template<class Alloc>
+FrozenHashMap<KeyT, ValueT, Hash, KeyEqual>::FrozenHashMap(const HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &source):
+        hasher(source.hash_function()),
+        keyEqual(source.key_eq())
+{
+    std::vector<const pairType *> pairs;
+    pairs.reserve(source.size());
+    for (const pairType &pair: source)
+    {
+        pairs.push_back(&pair);
+    }
+    _build(pairs);
+}
+
+/**
+ * @brief Builds a FrozenHashMap from a list of pairs, a later pair of a repeated key
+ * replaces the earlier one.
+ * @param list pairs to hold.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+FrozenHashMap<KeyT, ValueT, Hash, KeyEqual>::FrozenHashMap(std::initializer_list<pairType> list)
+{
+    HashMap<KeyT, ValueT, Hash, KeyEqual> unique;
+    unique.reserve(list.size());
+    for (const pairType &pair: list)
+    {
+        unique[pair.first] = pair.second;
+    }
+    *this = FrozenHashMap(unique);
+}
+
+/**
+ * @brief Chooses the pilots and places the pairs.
+ * Buckets are placed from the biggest to the smallest, trying pilots 0, 1, 2... for each
+ * until all of its keys land on free positions distinct from each other. Big buckets are
+ * placed while most positions are free, the many single key buckets fill the rest. With
+ * FROZEN_LOAD_FACTOR of the positions used, the last key needs about 50 pilots, where
+ * one position per key would need as many pilots as there are keys. Should a bucket still
+ * run out of pilots, positions are added and all buckets placed again.
+ * @param source pointers to the pairs to hold, with distinct keys.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+void FrozenHashMap<KeyT, ValueT, Hash, KeyEqual>::_build(const std::vector<const pairType *> &source)
+{
+    size_t numOfSlots = source.size();
+    pilots.assign((numOfSlots + FROZEN_BUCKET_SIZE - 1) / FROZEN_BUCKET_SIZE, 0);
+    remap.clear();
+    if (numOfSlots == 0)
+    {
+        return;
+    }
+    std::vector<size_t> hashes(numOfSlots);
+    for (size_t i = 0; i < numOfSlots; i++)
+    {
+        hashes[i] = _hash(source[i]->first);
+    }
+    // Group the keys by bucket with a counting sort.
+    std::vector<size_t> bucketStart(pilots.size() + 1, 0), byBucket(numOfSlots);
+    for (size_t i = 0; i < numOfSlots; i++)
+    {
+        bucketStart[_bucket(hashes[i], pilots.size()) + 1]++;
+    }
+    size_t biggest = 0;
+    for (size_t b = 0; b < pilots.size(); b++)
+    {
+        biggest = std::max(biggest, bucketStart[b + 1]);
+        bucketStart[b + 1] += bucketStart[b];
+    }
+    std::vector<size_t> fill(bucketStart.begin(), bucketStart.end() - 1);
+    for (size_t i = 0; i < numOfSlots; i++)
+    {
+        byBucket[fill[_bucket(hashes[i], pilots.size())]++] = i;
+    }
+    // Order the buckets from the biggest to the smallest, again with a counting sort.
+    std::vector<size_t> sizeStart(biggest + 2, 0), bySize(pilots.size());
+    for (size_t b = 0; b < pilots.size(); b++)
+    {
+        sizeStart[biggest - (bucketStart[b + 1] - bucketStart[b]) + 1]++;
+    }
+    for (size_t s = 0; s <= biggest; s++)
+    {
+        sizeStart[s + 1] += sizeStart[s];
+    }
+    for (size_t b = 0; b < pilots.size(); b++)
+    {
+        bySize[sizeStart[biggest - (bucketStart[b + 1] - bucketStart[b])]++] = b;
+    }
+    for (size_t b = 0; b < pilots.size(); b++)
+    {
+        for (size_t i = bucketStart[b]; i < bucketStart[b + 1]; i++)
+        {
+            for (size_t j = bucketStart[b]; j < i; j++)
+            {
+                // Such keys land on the same position under every pilot.
+                if (hashes[byBucket[i]] == hashes[byBucket[j]])
+                {
+                    throw std::invalid_argument(EQUAL_HASHES);
+                }
+            }
+        }
+    }
+    size_t numOfPositions = (size_t) ((double) numOfSlots / FROZEN_LOAD_FACTOR) + 1;
+    std::vector<size_t> owner;
+    while (!_placeBuckets(hashes, byBucket, bucketStart, bySize, numOfPositions, owner))
+    {
+        numOfPositions += numOfPositions / 16 + 1;
+    }
+    // Move the keys sent past the last slot to the free slots, in order.
+    remap.assign(numOfPositions - numOfSlots, 0);
+    size_t free = 0;
+    for (size_t place = numOfSlots; place < numOfPositions; place++)
+    {
+        if (owner[place] != NO_SLOT)
+        {
+            while (owner[free] != NO_SLOT)
+            {
+                free++;
+            }
+            owner[free] = owner[place];
+            remap[place - numOfSlots] = free;
+        }
+    }
+    slots.clear();
+    slots.reserve(numOfSlots);
+    for (size_t place = 0; place < numOfSlots; place++)
+    {
+        slots.push_back(*source[owner[place]]);
+    }
+}
+
+/**
+ * @brief Chooses a pilot for every bucket, sending all keys to distinct positions.
+ * @param hashes hash of every key.
+ * @param byBucket keys ordered by bucket.
+ * @param bucketStart index in byBucket of the first key of every bucket, and one past the last.
+ * @param bySize buckets from the biggest to the smallest.
+ * @param numOfPositions number of positions to send the keys to, at least the number of keys.
+ * @param owner set to the key sent to every position, NO_SLOT for free positions.
+ * @return true if every bucket found a pilot below FROZEN_MAX_PILOT, false otherwise.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+bool FrozenHashMap<KeyT, ValueT, Hash, KeyEqual>::_placeBuckets(const std::vector<size_t> &hashes,
+                                                                const std::vector<size_t> &byBucket,
+                                                                const std::vector<size_t> &bucketStart,
+                                                                const std::vector<size_t> &bySize,
+                                                                size_t numOfPositions, std::vector<size_t> &owner)
+{
+    owner.assign(numOfPositions, NO_SLOT);
+    // The search only asks whether positions are taken, a bit each keeps it in the cache.
+    std::vector<uint64_t> taken((numOfPositions + 63) / 64, 0);
+    std::vector<size_t> places(bucketStart[bySize[0] + 1] - bucketStart[bySize[0]]);
+    for (size_t b: bySize)
+    {
+        size_t first = bucketStart[b], size = bucketStart[b + 1] - first;
+        uint32_t pilot = 0;
+        for (; pilot < FROZEN_MAX_PILOT; pilot++)
+        {
+            size_t placed = 0;
+            for (; placed < size; placed++)
+            {
+                size_t place = _position(hashes[byBucket[first + placed]], pilot, numOfPositions);
+                if (taken[place / 64] >> (place % 64) & 1)
+                {
+                    break;
+                }
+                taken[place / 64] |= (uint64_t) 1 << (place % 64);
+                places[placed] = place;
+            }
+            if (placed == size)
+            {
+                break;
+            }
+            while (placed > 0)
+            {
+                placed--;
+                taken[places[placed] / 64] &= ~((uint64_t) 1 << (places[placed] % 64));
+            }
+        }
+        if (pilot == FROZEN_MAX_PILOT)
+        {
+            return false;
+        }
+        pilots[b] = pilot;
+        for (size_t i = 0; i < size; i++)
+        {
+            owner[places[i]] = byBucket[first + i];
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Get value by key.
+ * @param key to search by.
+ * @return reference to ValueT object if the map contains key, throws exception otherwise.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+const ValueT &FrozenHashMap<KeyT, ValueT, Hash, KeyEqual>::at(const KeyT &key) const
+{
+    size_t place = _locate(key);
+    if (place == NO_SLOT)
+    {
+        throw std::out_of_range(KEY_DOES_NOT_EXIST);
+    }
+    return slots[place].second;
+}
+
+
+#endif //CPP_EX3_FROZENHASHMAP_HPP
@@ -0,0 +1,262 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <type_traits>
+
+#ifndef CPP_EX3_HASHFUNCTIONS_HPP
+#define CPP_EX3_HASHFUNCTIONS_HPP
+
+#define GOLDEN_RATIO_64 0x9E3779B97F4A7C15ULL
+
+#define WYHASH_SECRET_0 0xA0761D6478BD642FULL
+
+#define WYHASH_SECRET_1 0xE7037ED1A0B428DBULL
+
+#define WYHASH_SECRET_2 0x8EBC6AF09C88C6E3ULL
+
+#define WYHASH_SECRET_3 0x589965CC75374CC3ULL
+
+/**
+ * @brief Multiplies two 64 bit numbers and folds the 128 bit product by xoring its halves.
+ * Every input bit reaches most output bits, which makes it a cheap finalizer.
+ * @param a first factor.
+ * @param b second factor.
+ * @return xor of the low and high halves of a * b.
+ */
+inline uint64_t foldedMultiply(uint64_t a, uint64_t b)
+{
+#ifdef __SIZEOF_INT128__
+    __uint128_t product = (__uint128_t) a * b;
+    return (uint64_t) (product >> 64) ^ (uint64_t) product;
+#else
+    uint64_t aLow = a & 0xFFFFFFFFULL, aHigh = a >> 32, bLow = b & 0xFFFFFFFFULL, bHigh = b >> 32;
+    uint64_t lowLow = aLow * bLow, lowHigh = aLow * bHigh, highLow = aHigh * bLow;
+    uint64_t middle = (lowLow >> 32) + (lowHigh & 0xFFFFFFFFULL) + (highLow & 0xFFFFFFFFULL);
+    uint64_t high = aHigh * bHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+    return high ^ ((middle << 32) | (lowLow & 0xFFFFFFFFULL));
+#endif
+}
+
+/**
+ * @brief Hash of integral and enum keys, a multiplication by the golden ratio folded to 64
+ * bits, so consecutive keys differ in both the low and the high bits of their hashes.
+ */
+struct IntegerHash
+{
+    /**
+     * @brief Marks the hash as spreading its input over all bits, HashMap uses it as is.
+     */
+    typedef void is_avalanching;
+
+    /**
+     * @param key integral or enum key.
+     * @return hash of key.
+     */
+    template<class T>
+    size_t operator()(T key) const
+    {
+        return (size_t) foldedMultiply((uint64_t) key, GOLDEN_RATIO_64);
+    }
+};
+
+/**
+ * @brief Hash of byte strings in the style of wyhash, reading 16 or 48 bytes per step and
+ * mixing them with folded multiplications. Far faster than libstdc++'s std::hash on
+ * std::string for anything but the shortest strings. std::string, std::string_view and
+ * const char* holding the same characters hash the same, so it is transparent.
+ */
+struct StringHash
+{
+    /**
+     * @brief Marks the hash as spreading its input over all bits, HashMap uses it as is.
+     */
+    typedef void is_avalanching;
+
+    /**
+     * @brief Marks the hash as accepting other types than the key type.
+     */
+    typedef void is_transparent;
+
+    /**
+     * @param data pointer to the first byte.
+     * @param length number of bytes.
+     * @param seed value changing the whole hash function.
+     * @return hash of the bytes.
+     */
+    static uint64_t hashBytes(const char *data, size_t length, uint64_t seed = 0)
+    {
+        const unsigned char *p = reinterpret_cast<const unsigned char *>(data);
+        seed ^= foldedMultiply(seed ^ WYHASH_SECRET_0, WYHASH_SECRET_1);
+        uint64_t a, b;
+        if (length <= 16)
+        {
+            if (length >= 4)
+            {
+                // Two overlapping pairs of 4 byte reads cover every length from 4 to 16.
+                size_t shift = (length >> 3) << 2;
+                a = (_read32(p) << 32) | _read32(p + shift);
+                b = (_read32(p + length - 4) << 32) | _read32(p + length - 4 - shift);
+            }
+            else if (length > 0)
+            {
+                a = ((uint64_t) p[0] << 16) | ((uint64_t) p[length >> 1] << 8) | p[length - 1];
+                b = 0;
+            }
+            else
+            {
+                a = b = 0;
+            }
+        }
+        else
+        {
+            size_t left = length;
+            if (left > 48)
+            {
+                uint64_t second = seed, third = seed;
+                do
+                {
+                    seed = foldedMultiply(_read64(p) ^ WYHASH_SECRET_1, _read64(p + 8) ^ seed);
+                    second = foldedMultiply(_read64(p + 16) ^ WYHASH_SECRET_2, _read64(p + 24) ^ second);
+                    third = foldedMultiply(_read64(p + 32) ^ WYHASH_SECRET_3, _read64(p + 40) ^ third);
+                    p += 48;
+                    left -= 48;
+                } while (left > 48);
+                seed ^= second ^ third;
+            }
+            while (left > 16)
+            {
+                seed = foldedMultiply(_read64(p) ^ WYHASH_SECRET_1, _read64(p + 8) ^ seed);
+                p += 16;
+                left -= 16;
+            }
+            a = _read64(p + left - 16);
+            b = _read64(p + left - 8);
+        }
+        return foldedMultiply(WYHASH_SECRET_1 ^ length,
+                              foldedMultiply(a ^ WYHASH_SECRET_1, b ^ seed) ^ WYHASH_SECRET_0);
+    }
+
+    /**
+     * @param key string to hash.
+     * @return hash of the string's bytes.
+     */
+    size_t operator()(const std::string &key) const
+    {
+        return (size_t) hashBytes(key.data(), key.size());
+    }
+
+    /**
+     * @param key view of the characters to hash.
+     * @return hash of the viewed bytes, equal to the hash of the same std::string.
+     */
+    size_t operator()(std::string_view key) const
+    {
+        return (size_t) hashBytes(key.data(), key.size());
+    }
+
+    /**
+     * @param key null terminated string to hash.
+     * @return hash of the string's bytes, equal to the hash of the same std::string.
+     */
+    size_t operator()(const char *key) const
+    {
+        return (size_t) hashBytes(key, std::strlen(key));
+    }
+
+private:
+    /**
+     * @param p pointer to 8 bytes.
+     * @return the bytes as a little endian number on little endian machines.
+     */
+    static uint64_t _read64(const unsigned char *p)
+    {
+        uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    /**
+     * @param p pointer to 4 bytes.
+     * @return the bytes as a number.
+     */
+    static uint64_t _read32(const unsigned char *p)
+    {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+};
+
+/**
+ * @brief Checks if a hash spreads its input over all bits of its result, which a hash
+ * declares with a nested is_avalanching type. HashMap mixes the result of other hashes,
+ * such as libstdc++'s identity hash of integers, before using it.
+ * @tparam H hash type.
+ */
+template<class H, class Enable = void>
+struct IsAvalanching : std::false_type
+{
+};
+
+template<class H>
+struct IsAvalanching<H, typename std::conditional<true, void, typename H::is_avalanching>::type> : std::true_type
+{
+};
+
+/**
+ * @brief Checks if a hash or an equality accepts other types than the key type, which it
+ * declares with a nested is_transparent type.
+ * @tparam F hash or equality type.
+ */
+template<class F, class Enable = void>
+struct IsTransparent : std::false_type
+{
+};
+
+template<class F>
+struct IsTransparent<F, typename std::conditional<true, void, typename F::is_transparent>::type> : std::true_type
+{
+};
+
+/**
+ * @brief Default hash of HashMap, IntegerHash for integral and enum keys, StringHash for
+ * std::string and std::hash for every other key.
+ * @tparam KeyT type of keys.
+ */
+template<class KeyT, class Enable = void>
+struct DefaultHash : std::hash<KeyT>
+{
+};
+
+template<class KeyT>
+struct DefaultHash<KeyT, typename std::enable_if<std::is_integral<KeyT>::value ||
+                                                 std::is_enum<KeyT>::value>::type> : IntegerHash
+{
+};
+
+template<>
+struct DefaultHash<std::string> : StringHash
+{
+};
+
+
+/**
+ * @brief Default equality of HashMap, std::equal_to<KeyT> for every key but std::string,
+ * which compares transparently to std::string_view and const char*.
+ * @tparam KeyT type of keys.
+ */
+template<class KeyT>
+struct DefaultEqual : std::equal_to<KeyT>
+{
+};
+
+template<>
+struct DefaultEqual<std::string> : std::equal_to<>
+{
+};
+
+
+#endif //CPP_EX3_HASHFUNCTIONS_HPP
@@ -2,509 +2,2440 @@
 // Created by Ophir's laptop on 20/01/2020.
 //
 #include <vector>
+#include <new>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <functional>
+#include <cstdint>
+#include <tuple>
+#include <memory>
+#include <type_traits>
+#include <algorithm>
+#include <thread>
+#include <exception>
+#include <system_error>
+#include "HashFunctions.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #ifndef CPP_EX3_HASHMAP_HPP
 #define CPP_EX3_HASHMAP_HPP
 
-#define UPPER_LOAD_FACTOR 0.75
+#define DEFAULT_UPPER_LOAD_FACTOR 0.75
 
-#define DEFAULT_CAPACITY 16
+#define INLINE_CAPACITY 4
 
-#define LOWER_LOAD_FACTOR 0.25
+#define DEFAULT_LOWER_LOAD_FACTOR 0.25
 
-#define KEY_DOES_NOT_EXIST "The hashMap doesn't contain this key"
-
-/**
- * @brief open HashMap holds ValueT object according to KeyT objects.
- * @tparam KeyT Objects to search ValueT by.
- * @tparam ValueT Object to hold.
- */
-template<class KeyT, class ValueT>
-class HashMap
-{
-private:
-    typedef std::vector<std::pair<KeyT, ValueT>> pairVector;
-
-    //private parameters
-    int maxCapacity, count;
-    pairVector *vec;
-
-    //private funcs
-    /**
-     * @brief hashes given key to index number between 0 and maxCapcity.
-     * @param key KeyT object to hash.
-     * @return number between 0 and maxCapacity.
-     */
-    int _hash(const KeyT &key) const;
+#define INVALID_LOAD_FACTORS "Load factors must satisfy 0 <= 2 * lower < upper < 1"
 
-    /**
-     * @brief Rehashes all keys in the HashMap to new HashMap of newCapacity capacity.
-     * @param newCapacity number of buckets after operation is done.
-     */
-    void _reHash(int newCapacity);
+#define KEY_DOES_NOT_EXIST "The hashMap doesn't contain this key"
 
-public:
-    /**
-     * @brief Default HashMap constructor.
-     */
-    HashMap();
+#define EMPTY_SLOT ((signed char) -128)
 
-    /**
-     * @brief Constructor that receives values in two separate vectors.
-     * @param keys const reference to KeyT object vector.
-     * @param values const reference to ValueT object vector.
-     */
-    HashMap(const std::vector<KeyT> &keys, const std::vector<ValueT> &values);
+#define DELETED_SLOT ((signed char) -2)
 
-    /**
-     * @brief Copy constructor
-     * @param other HashMap to copy.
-     */
-    HashMap(HashMap<KeyT, ValueT> &other);
+#define FRAGMENT_MASK 0x7F
 
-    /**
-     * @brief HashMap destructor.
-     */
-    ~HashMap();
+#define FRAGMENT_BITS 7
 
-    //functions
-    /**
-     * @brief count getter.
-     * @return number of items in HashMap.
-     */
-    int size() const;
+#if defined(__AVX2__)
+#define GROUP_WIDTH 32
+#else
+#define GROUP_WIDTH 16
+#endif
 
-    /**
-     * maxCapacity getter.
-     * @return number of buckets in HashMap.
-     */
-    int capacity() const;
+#define MIGRATION_STEP 32
 
-    /**
-     * @brief checks if the HashMap is empty.
-     * @return true if the HashMap is empty, false otherwise.
-     */
-    bool empty() const;
+#define NO_SLOT ((size_t) -1)
 
-    /**
-     * @brief inserts a new value to the HashMap at a certain key location.
-     * @param key to locate value by.
-     * @param val value to input in the HashMap.
-     * @return true if insertion was successful, false otherwise.
-     */
-    bool insert(const KeyT &key, const ValueT &val);
+#define PARALLEL_PAIRS_PER_THREAD (1 << 15)
 
-    /**
-     * @brief checks if a given key is contained in the HashMap.
-     * @param key the key to search for.
-     * @return true if the HashMap contains the key, false otherwise.
-     */
-    bool containsKey(const KeyT &key) const;
+#define REGIONS_PER_THREAD 8
 
-    /**
-     * @brief Get value by key.
-     * @param key to search by.
-     * @return reference to ValueT object if HashMap contains key, throws exception otherwise.
-     */
-    ValueT &at(const KeyT &key);
+#define MIN_REGION_SLOTS 1024
 
-    /**
-     * @brief Get value by key.
-     * @param key to search by.
-     * @return ValueT object if HashMap contains key, throws exception otherwise.
-     */
-    ValueT at(const KeyT &key) const;
+/**
+ * @brief open addressing HashMap holds ValueT object according to KeyT objects.
+ * All pairs are kept in one flat slot array, next to an array of control bytes
+ * telling for each slot if it is empty, deleted or full. A full slot's control byte holds
+ * the low FRAGMENT_BITS bits of its key's hash, the rest of the hash picks the slot to
+ * start probing at. Probing scans GROUP_WIDTH control bytes at a time (with SSE2/AVX2
+ * when available) and compares keys only on slots whose fragment and full hash match.
+ * The full hash of every key is kept next to its slot, so keys are hashed only once.
+ * In incremental rehash mode growing, shrinking and cleaning tombstones keep the old
+ * table alive and every following insertion or erasure moves MIGRATION_STEP of its slots,
+ * instead of moving all at once.
+ * The first INLINE_CAPACITY slots live inside the HashMap object, so an empty or tiny
+ * HashMap takes nothing from the allocator and is searched with a single group scan.
+ * @tparam KeyT Objects to search ValueT by.
+ * @tparam ValueT Object to hold.
+ * @tparam Hash hash of KeyT objects, its result is mixed first unless it is avalanching.
+ * @tparam KeyEqual equality of KeyT objects. Lookups accept other types than KeyT when both
+ * Hash and KeyEqual declare is_transparent, as the defaults for std::string keys do.
+ * @tparam Alloc allocator all tables are taken from, e.g. an ArenaAllocator.
+ */
+template<class KeyT, class ValueT, class Hash = DefaultHash<KeyT>, class KeyEqual = DefaultEqual<KeyT>,
+        class Alloc = std::allocator<std::pair<KeyT, ValueT>>>
+class HashMap
+{
+private:
+    typedef std::pair<KeyT, ValueT> pairType;
 
-    /**
-     * @brief Erases key and value from HashMap.
-     * @param key to erase.
-     * @return true if erasure was successful, false otherwise.
-     */
-    bool erase(const KeyT &key);
+    typedef std::allocator_traits<Alloc> allocTraits;
 
-    /**
-     * @return gets current (double) load factor of the HashMap.
-     */
-    double getLoadFactor() const;
+    typedef typename allocTraits::template rebind_alloc<pairType> pairAlloc;
 
-    /**
-     * @brief Checks how many items were hashed to a certain bucket.
-     * @param key to check size of bucket container.
-     * @return number of items in bucket containing key.
-     */
-    int bucketSize(const KeyT &key) const;
+    typedef typename allocTraits::template rebind_alloc<size_t> hashAlloc;
 
-    /**
-     * @param key to search
-     * @return index of bucket containing the key.
-     */
-    int bucketIndex(const KeyT &key) const;
+    typedef typename allocTraits::template rebind_alloc<signed char> ctrlAlloc;
 
     /**
-     * @brief clears all items from HashMap, doesn't update size.
+     * @brief true if moving a HashMap can't throw: only the pairs of an inline table are
+     * moved one by one, the hash and equality objects are copied.
      */
-    void clear();
+    static constexpr bool nothrowMovable = std::is_nothrow_move_constructible<pairType>::value &&
+                                           std::is_nothrow_copy_constructible<Hash>::value &&
+                                           std::is_nothrow_copy_assignable<Hash>::value &&
+                                           std::is_nothrow_copy_constructible<KeyEqual>::value &&
+                                           std::is_nothrow_copy_assignable<KeyEqual>::value;
 
     /**
-     * @brief iterator object of HashMap.
+     * @brief Arrays of one open addressing table and the probing over them.
      */
-    class const_iterator
+    struct Table
     {
-    public:
-        typedef int difference_type;
-
-        typedef std::pair<KeyT, ValueT> value_type;
-
-        typedef std::pair<KeyT, ValueT> *pointer;
-
-        typedef std::pair<KeyT, ValueT> &reference;
+        /**
+         * @brief Control byte of every slot, EMPTY_SLOT, DELETED_SLOT or the hash fragment
+         * of a full slot, followed by GROUP_WIDTH clones of the first bytes so a group may be
+         * read from any slot without wrapping.
+         */
+        signed char *ctrl;
 
-        typedef std::forward_iterator_tag iterator_category;
-    private:
         /**
-         * @brief Index of bucket containing current item.
+         * @brief Flat array of capacity slots, only slots marked full are constructed.
          */
-        int bucket;
+        pairType *slots;
 
         /**
-         * @brief Index of current item in it's containing bucket.
+         * @brief Full hash of the key in every full slot.
          */
-        int indexInBucket;
+        size_t *hashes;
 
         /**
-         * @brief Number of buckets in HashMap.
+         * @brief Number of slots, a power of two.
          */
-        int icapacity;
+        size_t capacity;
 
         /**
-         * @brief Pointer to array of vector<KeyT, ValueT> containing items to iterate over.
+         * @brief Constructor of a table without arrays.
          */
-        pairVector *ivec;
+        Table() :
+                ctrl(nullptr), slots(nullptr), hashes(nullptr), capacity(0)
+        {
+        }
 
         /**
-         * @brief Pointer to current pair of KeyT object, ValueT object.
+         * @param hash full hash of a key.
+         * @return slot between 0 and capacity the key's probe sequence starts at.
          */
-        pointer current;
+        size_t home(size_t hash) const
+        {
+            return (hash >> FRAGMENT_BITS) & (capacity - 1);
+        }
 
-    public:
+        /**
+         * @return mask of the group bits standing for distinct slots, tables smaller than a
+         * group see each slot more than once in a group.
+         */
+        unsigned int groupMask() const
+        {
+            return capacity < GROUP_WIDTH ? (1u << capacity) - 1 : ~0u >> (32 - GROUP_WIDTH);
+        }
 
         /**
-         * @brief Constructor of Iterator, finding first items.
-         * @param mVec pointer to array of vectors to iterate over.
-         * @param capacity number of vectors in the array.
+         * @brief Looks for the slot holding key.
+         * @param key to search for.
+         * @param hash full hash of key.
+         * @param equal equality of keys.
+         * @return index of the slot holding key, NO_SLOT if key isn't in the table.
          */
-        const_iterator(pairVector *mVec, int capacity) :
-                bucket(0), indexInBucket(0), icapacity(capacity), ivec(mVec), current(nullptr)
+        template<class K>
+        size_t find(const K &key, size_t hash, const KeyEqual &equal) const
         {
-            if (mVec == nullptr)
+            size_t mask = capacity - 1;
+            signed char fragment = _fragment(hash);
+            for (size_t pos = home(hash);; pos = (pos + GROUP_WIDTH) & mask)
             {
-                return;
+                const signed char *group = ctrl + pos;
+                for (unsigned int match = _matchByte(group, fragment) & groupMask();
+                     match != 0; match &= match - 1)
+                {
+                    size_t i = (pos + __builtin_ctz(match)) & mask;
+                    if (hashes[i] == hash && equal(slots[i].first, key))
+                    {
+                        return i;
+                    }
+                }
+                if (_matchByte(group, EMPTY_SLOT) != 0)
+                {
+                    return NO_SLOT;
+                }
             }
-            for (int i = 0; i < capacity; ++i)
+        }
+
+        /**
+         * @brief Looks for the first slot a new key may be placed in.
+         * @param hash full hash of the key.
+         * @return index of the first empty or deleted slot in the key's probe sequence.
+         */
+        size_t findFree(size_t hash) const
+        {
+            size_t mask = capacity - 1;
+            for (size_t pos = home(hash);; pos = (pos + GROUP_WIDTH) & mask)
             {
-                if (ivec[i].size() != 0)
+                unsigned int match = _matchFree(ctrl + pos) & groupMask();
+                if (match != 0)
                 {
-                    bucket = i;
-                    current = &(ivec[i][0]);
-                    return;
+                    return (pos + __builtin_ctz(match)) & mask;
                 }
             }
         }
 
         /**
-         * @brief * operator overload when *<const_iter_name> is called.
-         * @return dereference of current.
+         * @brief Sets the control byte of a slot and its clone.
+         * @param slot index of the slot.
+         * @param c new control byte.
          */
-        reference operator*()
+        void setCtrl(size_t slot, signed char c)
         {
-            return *current;
+            ctrl[slot] = c;
+            for (size_t i = slot + capacity; i < capacity + GROUP_WIDTH; i += capacity)
+            {
+                ctrl[i] = c;
+            }
         }
 
         /**
-         * @brief -> operator overload when <const_iter_name>-> is called.
-         * @return current which is a pointer to std::pair of KeyT and ValueT objects
+         * @brief Moves a pair into the first free slot of its probe sequence.
+         * @param pair to move, left to be destroyed by the caller.
+         * @param hash full hash of pair's key.
+         * @return index of the slot pair was moved to.
          */
-        pointer operator->()
+        size_t moveIn(pairType &pair, size_t hash)
         {
-            return current;
+            size_t place = findFree(hash);
+            moveTo(place, pair, hash);
+            return place;
         }
 
         /**
-         * @brief ++ operator overload when ++<const_iter_name> is called.
-         * @return advances the current and indexes to the next item and returns the iterator,
-         * when last is reached points to nullptr.
+         * @brief Moves a pair into a given free slot.
+         * @param place index of an empty or deleted slot in the key's probe sequence.
+         * @param pair to move, left to be destroyed by the caller.
+         * @param hash full hash of pair's key.
          */
-        const_iterator &operator++()
+        void moveTo(size_t place, pairType &pair, size_t hash)
         {
-            if (ivec == nullptr)
-            {
-                current = nullptr;
-                return *this;
-            }
-            if (indexInBucket + 1 < (int) ivec[bucket].size())
-            {
-                indexInBucket++;
-            }
-            else
-            {
-                indexInBucket = 0;
-                bucket++;
-                while (bucket < icapacity && ivec[bucket].size() == 0)
-                {
-                    bucket++;
-                }
-                if (bucket == icapacity)
-                {
-                    current = nullptr;
-                    return *this;
-                }
-            }
-            current = &(ivec[bucket][indexInBucket]);
-            return *this;
+            new(slots + place) pairType(std::move_if_noexcept(pair));
+            hashes[place] = hash;
+            setCtrl(place, _fragment(hash));
         }
 
         /**
-         * @brief ++ operator overload when <const_iter_name>++ is called.
-         * @return advances the current and indexes to the next item and returns an iterator
-         * pointing to the previous item.
+         * @brief Destroys the pair in a full slot and marks the slot empty, or deleted if a
+         * probe sequence may have passed it.
+         * @param slot index of the slot.
+         * @return true if the slot was marked deleted.
          */
-        const_iterator operator++(int)
+        bool clearSlot(size_t slot)
         {
-            const_iterator temp = *this;
-            ++(*this);
-            return temp;
+            slots[slot].~pairType();
+            // A probe stops at the first group holding an empty slot, so if every group the
+            // slot may be seen in already holds one, no probe sequence ever went past it.
+            bool neverPassed = capacity < GROUP_WIDTH;
+            if (!neverPassed)
+            {
+                unsigned int emptyBefore = _matchByte(ctrl + ((slot - GROUP_WIDTH) & (capacity - 1)),
+                                                      EMPTY_SLOT);
+                unsigned int emptyAfter = _matchByte(ctrl + slot, EMPTY_SLOT);
+                neverPassed = emptyBefore != 0 && emptyAfter != 0 &&
+                              __builtin_ctz(emptyAfter) + __builtin_clz(emptyBefore) -
+                              (32 - GROUP_WIDTH) < GROUP_WIDTH;
+            }
+            setCtrl(slot, neverPassed ? EMPTY_SLOT : DELETED_SLOT);
+            return !neverPassed;
         }
 
         /**
-         * @brief == operator overload when <const_iter_name>==<other_const_iter_name> is called.
-         * @return true if both iterator point to the same pair.
+         * @brief Probes a key's sequence without going past a given slot, for the threads of a
+         * parallel rehash or build, which each own a range of slots. Only for tables without
+         * deleted slots, where the first free slot of a probe sequence is its first empty one.
+         * @param hash full hash of the key.
+         * @param end slot the probe stops before, after the key's home slot.
+         * @param key key to look for, nullptr to only look for an empty slot.
+         * @param equal equality of keys.
+         * @return index of the slot holding key, or else of the first empty slot, NO_SLOT if
+         * the probe reached end first.
          */
-        bool operator==(const_iterator const &other) const
+        size_t probeRange(size_t hash, size_t end, const KeyT *key, const KeyEqual &equal) const
         {
-            return other.current == current;
+            for (size_t i = home(hash); i < end; i++)
+            {
+                if (!_isFull(ctrl[i]) ||
+                    (key != nullptr && hashes[i] == hash && equal(slots[i].first, *key)))
+                {
+                    return i;
+                }
+            }
+            return NO_SLOT;
         }
 
         /**
-         * @brief != operator overload when <const_iter_name>==<other_const_iter_name> is called.
-         * @return true if both iterator point to the a different pair.
+         * @brief Counts the pairs sharing a home slot.
+         * @param homeSlot slot to count the pairs of.
+         * @return number of pairs whose probe sequence starts at homeSlot.
          */
-        bool operator!=(const_iterator const &other) const
+        size_t countHome(size_t homeSlot) const
         {
-            return other.current != current;
+            size_t mask = capacity - 1, size = 0;
+            for (size_t pos = homeSlot;; pos = (pos + GROUP_WIDTH) & mask)
+            {
+                for (unsigned int full = ~_matchFree(ctrl + pos) & groupMask(); full != 0;
+                     full &= full - 1)
+                {
+                    if (home(hashes[(pos + __builtin_ctz(full)) & mask]) == homeSlot)
+                    {
+                        size++;
+                    }
+                }
+                if (_matchByte(ctrl + pos, EMPTY_SLOT) != 0)
+                {
+                    return size;
+                }
+            }
         }
     };
 
+    //private parameters
     /**
-     * @return A const iterator pointing to the first item in the HashMap.
+     * @brief Number of pairs in both tables and number of deleted slots in table.
      */
-    const_iterator begin() const
-    {
-        return const_iterator(vec, maxCapacity);
-    }
+    size_t numOfPairs, tombstones;
 
     /**
-     * @return A const iterator pointing to nullptr.
+     * @brief Index of the first full slot of table, table.capacity if table is empty.
      */
-    const_iterator end() const
-    {
-        return const_iterator(nullptr, 0);
-    }
+    size_t firstFull;
 
     /**
-     * @return A const iterator pointing to the first item in the HashMap.
+     * @brief Table new pairs are placed in.
      */
-    const_iterator cbegin() const
-    {
-        return const_iterator(vec, maxCapacity);
-    }
+    Table table;
 
     /**
-     * @return A const iterator pointing to nullptr.
+     * @brief Table an incremental rehash moves pairs from, without arrays when no incremental
+     * rehash is running.
      */
-    const_iterator cend() const
-    {
-        return const_iterator(nullptr, 0);
-    }
+    Table oldTable;
 
-    //operators
+    /**
+     * @brief Number of pairs left in oldTable and number of its slots already moved.
+     */
+    size_t oldCount, migrated;
 
     /**
-     * @brief = operator overload when <HashMap_name>=<other_HashMap_name> is called,
-     * Copies data from other HashMap to this HashMap.
-     * @return Reference to current HashMap
+     * @brief true if growing should move pairs incrementally.
      */
-    HashMap<KeyT, ValueT> &operator=(const HashMap<KeyT, ValueT> &other);
+    bool incremental;
 
     /**
-     * @brief [] operator overload when <HashMap_name>[KeyT key] is called.
-     * @return Reference to the ValueT item in the key place if it exists,
-     * otherwise inserts default ValueT value and returns reference to it.
+     * @brief Most threads a full rehash uses, one per PARALLEL_PAIRS_PER_THREAD pairs.
      */
-    ValueT &operator[](const KeyT &key);
+    unsigned int rehashThreads;
 
     /**
-     * @brief [] operator overload when const <HashMap_name>[KeyT key] is called.
-     * @return Reference to the ValueT item in the key place if it exists,
-     * otherwise returns a reference to default ValueT.
+     * @brief Load factor above which the HashMap grows and load factor below which it
+     * shrinks, 0 if it never shrinks by itself.
      */
-    ValueT operator[](const KeyT &key) const;
+    double upperLoadFactor, lowerLoadFactor;
 
     /**
-     * @brief == operator overload when const <HashMap_name>==<other_HashMap_name> is called.
-     * @return true if the group of keyT, ValueT pairs in current is
-     * equal to the group of other HashMap, false otherwise.
+     * @brief Capacity the HashMap never shrinks below by itself, set by reserve().
+     */
+    size_t minCapacity;
+
+    /**
+     * @brief Slots, hashes and control bytes of the inline table, which table uses while
+     * the HashMap is small.
+     */
+    alignas(pairType) unsigned char inlineSlots[INLINE_CAPACITY * sizeof(pairType)];
+
+    size_t inlineHashes[INLINE_CAPACITY];
+
+    signed char inlineCtrl[INLINE_CAPACITY + GROUP_WIDTH];
+
+    /**
+     * @brief Hash of keys.
+     */
+    Hash hasher;
+
+    /**
+     * @brief Equality of keys.
+     */
+    KeyEqual keyEqual;
+
+    /**
+     * @brief Allocator control bytes, slots and hashes are taken from.
+     */
+    Alloc allocator;
+
+    //private funcs
+    /**
+     * @brief hashes given key, mixing the bits so both the fragment and the home slot
+     * depend on the whole hash.
+     * @param key KeyT object, or object Hash accepts if lookups are transparent, to hash.
+     * @return full hash of key.
+     */
+    template<class K>
+    size_t _hash(const K &key) const;
+
+    /**
+     * @brief Looks for a key in both tables.
+     * @param key KeyT object, or object KeyEqual compares to keys if lookups are transparent.
+     * @return table and index of the slot holding key, nullptr and NO_SLOT if key isn't in the HashMap.
+     */
+    template<class K>
+    std::pair<const Table *, size_t> _locate(const K &key) const;
+
+    /**
+     * @brief Looks for a key in both tables, given its hash.
+     * @param key KeyT object, or object KeyEqual compares to keys if lookups are transparent.
+     * @param hash full hash of key.
+     * @return table and index of the slot holding key, nullptr and NO_SLOT if key isn't in the HashMap.
+     */
+    template<class K>
+    std::pair<const Table *, size_t> _locate(const K &key, size_t hash) const;
+
+    /**
+     * @brief Get value by key.
+     * @param key KeyT object, or object KeyEqual compares to keys if lookups are transparent.
+     * @return reference to ValueT object if HashMap contains key, throws exception otherwise.
      */
-    bool operator==(const HashMap<KeyT, ValueT> &other) const;
+    template<class K>
+    ValueT &_valueAt(const K &key) const;
+
+    /**
+     * @brief Enables the lookups taking other types than KeyT, only when both Hash and
+     * KeyEqual declare is_transparent.
+     */
+    template<class K>
+    using _transparent = typename std::enable_if<IsTransparent<Hash>::value && IsTransparent<KeyEqual>::value,
+            K>::type;
+
+    /**
+     * @param hash full hash of a key.
+     * @return control byte of a full slot holding the key.
+     */
+    static signed char _fragment(size_t hash)
+    {
+        return (signed char) (hash & FRAGMENT_MASK);
+    }
+
+    /**
+     * @param group pointer to GROUP_WIDTH control bytes.
+     * @param c control byte to look for.
+     * @return bit mask with bit i set if group[i] equals c.
+     */
+    static unsigned int _matchByte(const signed char *group, signed char c);
+
+    /**
+     * @param group pointer to GROUP_WIDTH control bytes.
+     * @return bit mask with bit i set if group[i] is empty or deleted.
+     */
+    static unsigned int _matchFree(const signed char *group);
+
+    /**
+     * @brief Allocates empty control bytes and slots for capacity slots, using the inline
+     * arrays when they are big enough and no table uses them.
+     * @param capacity number of slots to allocate, at least INLINE_CAPACITY.
+     * @return table holding the new arrays.
+     */
+    Table _allocate(size_t capacity);
+
+    /**
+     * @param old a table of this HashMap.
+     * @return true if old uses the inline arrays.
+     */
+    bool _isInline(const Table &old) const
+    {
+        return old.ctrl == inlineCtrl;
+    }
+
+    /**
+     * @brief Takes all pairs and settings of another HashMap, moving the pairs of an inline
+     * table one by one and stealing the arrays of any other table. This HashMap must be
+     * empty, without an incremental rehash running.
+     * @param other HashMap to move from, left as a valid empty HashMap.
+     */
+    void _moveFrom(HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &other);
+
+    /**
+     * @brief Destroys all pairs and frees control bytes and slots of both tables.
+     */
+    void _release();
+
+    /**
+     * @brief Gives the arrays of a table back to the allocator, or the inline arrays back to
+     * this HashMap, leaving the table without arrays. Does nothing to a table without arrays.
+     * @param old table whose pairs were all destroyed.
+     */
+    void _deallocate(Table &old);
+
+    /**
+     * @brief Destroys every pair in a table.
+     * @param old table to destroy the pairs of.
+     */
+    static void _destroyAll(const Table &old);
+
+    /**
+     * @brief Copies every pair of another HashMap into this empty one.
+     * @param other HashMap to copy.
+     */
+    void _copyFrom(const HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &other);
+
+    /**
+     * @brief Grows the HashMap, or cleans its tombstones, if one more pair would not fit. Too
+     * many tombstones are cleaned in place only while the live load factor is at most half the
+     * upper one, or twice the lower one if that is more, otherwise the HashMap grows.
+     */
+    void _makeRoomForOne();
+
+    /**
+     * @return true if one more pair fits in table without growing or cleaning tombstones.
+     */
+    bool _fitsOneMore() const;
+
+    /**
+     * @brief Looks for key and constructs a new pair for it in place if it is missing.
+     * @param key to look for, forwarded to the new pair's key.
+     * @param args forwarded to the new pair's value constructor.
+     * @return index of the slot in table holding key and true if a new pair was constructed.
+     */
+    template<class K, class... Args>
+    std::pair<size_t, bool> _tryEmplace(K &&key, Args &&... args);
+
+    /**
+     * @brief Looks for key, given its hash, and constructs a new pair for it in place if it
+     * is missing.
+     * @param hash full hash of key.
+     * @param key to look for, forwarded to the new pair's key.
+     * @param args forwarded to the new pair's value constructor.
+     * @return index of the slot in table holding key and true if a new pair was constructed.
+     */
+    template<class K, class... Args>
+    std::pair<size_t, bool> _tryEmplaceHashed(size_t hash, K &&key, Args &&... args);
+
+    /**
+     * @brief Looks for key to change it, moving it to table first if it is in oldTable.
+     * @param key to search for.
+     * @param hash full hash of key.
+     * @return index of the slot in table holding key, NO_SLOT if key isn't in the HashMap.
+     */
+    size_t _findForUpdate(const KeyT &key, size_t hash);
+
+    /**
+     * @brief Rehashes all keys in the HashMap to new HashMap of newCapacity capacity,
+     * using the stored hashes.
+     * @param newCapacity number of buckets after operation is done.
+     */
+    void _reHash(size_t newCapacity);
+
+    /**
+     * @brief Sets firstFull to the first full slot of table from a given slot on.
+     * @param from slot to start at, no slot before it may be full.
+     */
+    void _findFirstFull(size_t from);
+
+    /**
+     * @brief Moves the pairs of both tables to an empty table on several threads, each
+     * thread owning a range of the new table's slots. Pairs must be nothrow movable, so it
+     * throws only before moving any pair.
+     * @param fresh table to move the pairs to, without deleted slots.
+     * @param threads number of threads, the calling thread included.
+     */
+    void _parallelMoveIn(Table &fresh, unsigned int threads);
+
+    /**
+     * @brief Inserts the pairs of two vectors on several threads, each thread owning a
+     * range of table's slots. A later pair of a repeated key replaces the earlier one.
+     * table must be big enough for all pairs and have no deleted slots.
+     * @param keys keys to insert.
+     * @param values values of the keys.
+     * @param threads number of threads, the calling thread included.
+     */
+    void _parallelBuild(const std::vector<KeyT> &keys, const std::vector<ValueT> &values, unsigned int threads);
+
+    /**
+     * @param items number of pairs to rehash or insert.
+     * @return number of threads to do it on, at most rehashThreads and one per
+     * PARALLEL_PAIRS_PER_THREAD pairs, so starting a thread costs little next to its share.
+     */
+    unsigned int _parallelThreads(size_t items) const
+    {
+        size_t threads = std::min((size_t) rehashThreads, items / PARALLEL_PAIRS_PER_THREAD);
+        return threads == 0 ? 1 : (unsigned int) threads;
+    }
+
+    /**
+     * @param capacity number of slots of the table to split.
+     * @param threads number of threads filling the table.
+     * @return number of slot ranges a parallel rehash or build splits the table into.
+     */
+    static size_t _numOfRegions(size_t capacity, unsigned int threads)
+    {
+        size_t regions = 1;
+        while (regions < (size_t) threads * REGIONS_PER_THREAD && capacity / regions > MIN_REGION_SLOTS)
+        {
+            regions *= 2;
+        }
+        return regions;
+    }
+
+    /**
+     * @brief Calls work(0), ..., work(threads - 1) on threads threads, the calling thread
+     * being one of them, and waits for all. A thread that can't be started, for any reason,
+     * leaves its work to the calling thread.
+     * @param threads number of calls.
+     * @param work called with the index of the call, its exceptions are rethrown once all
+     * calls are done.
+     */
+    template<class Function>
+    static void _parallelFor(unsigned int threads, Function work);
+
+    /**
+     * @brief Starts an incremental rehash, turning table to oldTable.
+     * @param newCapacity number of buckets in the new table.
+     */
+    void _startMigration(size_t newCapacity);
+
+    /**
+     * @brief Rehashes to newCapacity buckets, at once, or in incremental mode by finishing a
+     * running migration and starting a new one.
+     * @param newCapacity number of buckets after operation is done.
+     */
+    void _resize(size_t newCapacity);
+
+    /**
+     * @param items number of pairs.
+     * @return smallest capacity holding items pairs without growing.
+     */
+    size_t _fitCapacity(size_t items) const;
+
+    /**
+     * @brief Moves pairs of oldTable to table, freeing oldTable once it is empty.
+     * @param steps maximal number of oldTable slots to go over.
+     */
+    void _migrate(size_t steps);
+
+    /**
+     * @brief Moves the pair in a slot of oldTable to table.
+     * @param slot index of a full slot of oldTable.
+     * @return index of the slot in table the pair was moved to.
+     */
+    size_t _migrateSlot(size_t slot);
+
+    /**
+     * @return true if an incremental rehash is running.
+     */
+    bool _migrating() const
+    {
+        return oldTable.ctrl != nullptr;
+    }
+
+    /**
+     * @param c control byte.
+     * @return true if c marks a full slot.
+     */
+    static bool _isFull(signed char c)
+    {
+        return c >= 0;
+    }
+
+public:
+    /**
+     * @brief Type of sizes, capacities and bucket indexes, 64 bit on 64 bit machines.
+     */
+    typedef size_t size_type;
+
+    /**
+     * @brief Default HashMap constructor.
+     */
+    HashMap();
+
+    /**
+     * @brief HashMap constructor taking its tables from a given allocator.
+     * @param alloc allocator to use.
+     */
+    explicit HashMap(const Alloc &alloc);
+
+    /**
+     * @brief HashMap constructor with given hash and equality objects.
+     * @param hash hash of keys.
+     * @param equal equality of keys.
+     * @param alloc allocator to use.
+     */
+    explicit HashMap(const Hash &hash, const KeyEqual &equal = KeyEqual(), const Alloc &alloc = Alloc());
+
+    /**
+     * @brief Constructor that receives values in two separate vectors.
+     * @param keys const reference to KeyT object vector.
+     * @param values const reference to ValueT object vector.
+     * @param alloc allocator to use.
+     */
+    HashMap(const std::vector<KeyT> &keys, const std::vector<ValueT> &values,
+            const Alloc &alloc = Alloc());
+
+    /**
+     * @brief Constructor that receives values in two separate vectors and inserts them on
+     * several threads, each owning a range of the slots. Holds the same pairs as the
+     * serial constructor, and keeps using threads for its rehashes.
+     * @param keys const reference to KeyT object vector.
+     * @param values const reference to ValueT object vector.
+     * @param threads number of threads to use, as in setParallelRehash.
+     * @param alloc allocator to use.
+     */
+    HashMap(const std::vector<KeyT> &keys, const std::vector<ValueT> &values, unsigned int threads,
+            const Alloc &alloc = Alloc());
+
+    /**
+     * @brief Copy constructor
+     * @param other HashMap to copy.
+     */
+    HashMap(const HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &other);
+
+    /**
+     * @brief Move constructor, takes other's pairs without copying them. Doesn't throw
+     * unless moving a pair or copying the hash or equality object may throw.
+     * @param other HashMap to move from, left as a valid empty HashMap.
+     */
+    HashMap(HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &&other) noexcept(nothrowMovable);
+
+    /**
+     * @brief HashMap destructor.
+     */
+    ~HashMap();
+
+    //functions
+    /**
+     * @brief numOfPairs getter.
+     * @return number of items in HashMap.
+     */
+    size_type size() const;
+
+    /**
+     * capacity getter.
+     * @return number of buckets in HashMap.
+     */
+    size_type capacity() const;
+
+    /**
+     * @brief checks if the HashMap is empty.
+     * @return true if the HashMap is empty, false otherwise.
+     */
+    bool empty() const;
+
+    /**
+     * @brief inserts a new value to the HashMap at a certain key location.
+     * @param key to locate value by.
+     * @param val value to input in the HashMap.
+     * @return true if insertion was successful, false otherwise.
+     */
+    bool insert(const KeyT &key, const ValueT &val);
+
+    /**
+     * @brief inserts a new value to the HashMap at a certain key location, moving both.
+     * @param key to locate value by.
+     * @param val value to input in the HashMap.
+     * @return true if insertion was successful, false otherwise.
+     */
+    bool insert(KeyT &&key, ValueT &&val);
+
+    /**
+     * @brief builds a KeyT, ValueT pair from args and moves it into the HashMap.
+     * @param args arguments of a std::pair<KeyT, ValueT> constructor.
+     * @return true if insertion was successful, false if the key was already in the HashMap.
+     */
+    template<class... Args>
+    bool emplace(Args &&... args);
+
+    /**
+     * @brief constructs a value from args in place if key isn't in the HashMap,
+     * args are left untouched otherwise.
+     * @param key to locate value by.
+     * @param args arguments of a ValueT constructor.
+     * @return true if insertion was successful, false if the key was already in the HashMap.
+     */
+    template<class... Args>
+    bool try_emplace(const KeyT &key, Args &&... args);
+
+    /**
+     * @brief constructs a value from args in place if key isn't in the HashMap, moving key
+     * into it. Key and args are left untouched otherwise.
+     * @param key to locate value by.
+     * @param args arguments of a ValueT constructor.
+     * @return true if insertion was successful, false if the key was already in the HashMap.
+     */
+    template<class... Args>
+    bool try_emplace(KeyT &&key, Args &&... args);
+
+    /**
+     * @brief checks if a given key is contained in the HashMap.
+     * @param key the key to search for.
+     * @return true if the HashMap contains the key, false otherwise.
+     */
+    bool containsKey(const KeyT &key) const;
+
+    /**
+     * @brief Counts the pairs of a key.
+     * @param key the key to search for.
+     * @return 1 if the HashMap contains the key, 0 otherwise.
+     */
+    size_type count(const KeyT &key) const;
+
+    /**
+     * @brief Get value by key.
+     * @param key to search by.
+     * @return reference to ValueT object if HashMap contains key, throws exception otherwise.
+     */
+    ValueT &at(const KeyT &key);
+
+    /**
+     * @brief Get value by key.
+     * @param key to search by.
+     * @return ValueT object if HashMap contains key, throws exception otherwise.
+     */
+    ValueT at(const KeyT &key) const;
+
+    /**
+     * @brief Erases key and value from HashMap.
+     * @param key to erase.
+     * @return true if erasure was successful, false otherwise.
+     */
+    bool erase(const KeyT &key);
+
+    /**
+     * @return gets current (double) load factor of the HashMap.
+     */
+    double getLoadFactor() const;
+
+    /**
+     * @return copy of the hash of keys.
+     */
+    Hash hash_function() const
+    {
+        return hasher;
+    }
+
+    /**
+     * @return copy of the equality of keys.
+     */
+    KeyEqual key_eq() const
+    {
+        return keyEqual;
+    }
+
+    /**
+     * @brief Checks how many items were hashed to a certain bucket.
+     * @param key to check size of bucket container.
+     * @return number of items in bucket containing key.
+     */
+    size_type bucketSize(const KeyT &key) const;
+
+    /**
+     * @param key to search
+     * @return index of bucket containing the key.
+     */
+    size_type bucketIndex(const KeyT &key) const;
+
+    /**
+     * @brief clears all items from HashMap, doesn't update size.
+     */
+    void clear();
+
+    /**
+     * @brief Exchanges the contents of this HashMap with other's.
+     * @param other HashMap to swap with.
+     */
+    void swap(HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &other);
+
+    /**
+     * @brief Grows the HashMap so it holds at least items pairs without rehashing, and keeps
+     * it from shrinking below that size by itself until shrink_to_fit() is called.
+     * @param items number of pairs to make room for.
+     */
+    void reserve(size_type items);
+
+    /**
+     * @brief Shrinks the HashMap to the smallest capacity holding its pairs, and forgets
+     * the size given to reserve().
+     */
+    void shrink_to_fit();
+
+    /**
+     * @brief Sets the load factors the HashMap grows above and shrinks below. A shrink
+     * halves the load factor, so lower must be under half of upper for the HashMap not to
+     * grow right back, and growing must leave empty slots for probes to stop at.
+     * Throws std::invalid_argument unless 0 <= 2 * lower < upper < 1.
+     * @param upper load factor above which an insertion grows the HashMap.
+     * @param lower load factor below which an erasure shrinks the HashMap, 0 never shrinks.
+     */
+    void setLoadFactors(double upper, double lower);
+
+    /**
+     * @brief Turns incremental rehashing on or off. When on, growing, shrinking and cleaning
+     * tombstones allocate the new table and leave the pairs where they are, the following
+     * insertions and erasures move them a few slots at a time, so no single insertion or
+     * erasure pays for moving all pairs. erase_if still shrinks at once.
+     * Turning it off finishes a running rehash.
+     * @param enable true to rehash incrementally.
+     */
+    void setIncrementalRehash(bool enable);
+
+    /**
+     * @brief Sets the most threads rehashing a HashMap uses. Each thread gets at least
+     * PARALLEL_PAIRS_PER_THREAD pairs, so small rehashes stay on fewer threads or on the
+     * calling thread, where starting threads would cost more than it saves. The pairs are
+     * split between the threads by their slot in the new table, so threads never write the
+     * same slots. Pairs whose move may throw are always moved by the calling thread.
+     * Incremental rehashes are not affected.
+     * @param threads number of threads, 0 and 1 rehash on the calling thread.
+     */
+    void setParallelRehash(unsigned int threads);
+
+    /**
+     * @brief iterator object of HashMap.
+     */
+    class const_iterator
+    {
+        friend class HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>;
+
+    public:
+        typedef std::ptrdiff_t difference_type;
+
+        typedef std::pair<KeyT, ValueT> value_type;
+
+        typedef const std::pair<KeyT, ValueT> *pointer;
+
+        typedef const std::pair<KeyT, ValueT> &reference;
+
+        typedef std::forward_iterator_tag iterator_category;
+    protected:
+        /**
+         * @brief Index of the slot holding current item.
+         */
+        size_t bucket;
+
+        /**
+         * @brief Number of slots in the table iterated over.
+         */
+        size_t icapacity;
+
+        /**
+         * @brief Pointer to the control bytes of the slots to iterate over.
+         */
+        const signed char *ictrl;
+
+        /**
+         * @brief Pointer to the slots to iterate over.
+         */
+        pairType *islots;
+
+        /**
+         * @brief Table to iterate over once this one is done, nullptr if there is none.
+         */
+        const Table *inext;
+
+        /**
+         * @brief Pointer to current pair of KeyT object, ValueT object.
+         */
+        pairType *current;
+
+    public:
+
+        /**
+         * @brief Constructor of Iterator, finding first items.
+         * @param first table to iterate over, nullptr for an end iterator.
+         * @param next table to iterate over after first, nullptr if there is none.
+         */
+        const_iterator(const Table *first, const Table *next) :
+                bucket(NO_SLOT), icapacity(0), ictrl(nullptr), islots(nullptr), inext(next),
+                current(nullptr)
+        {
+            if (first == nullptr)
+            {
+                return;
+            }
+            icapacity = first->capacity;
+            ictrl = first->ctrl;
+            islots = first->slots;
+            ++(*this);
+        }
+
+        /**
+         * @brief Constructor of Iterator pointing to the item in a given slot.
+         * @param first table holding the item.
+         * @param next table to iterate over after first, nullptr if there is none.
+         * @param slot index of a full slot to point to.
+         */
+        const_iterator(const Table *first, const Table *next, size_t slot) :
+                bucket(slot), icapacity(first->capacity), ictrl(first->ctrl),
+                islots(first->slots), inext(next), current(first->slots + slot)
+        {
+        }
+
+        /**
+         * @brief * operator overload when *<const_iter_name> is called.
+         * @return dereference of current.
+         */
+        reference operator*() const
+        {
+            return *current;
+        }
+
+        /**
+         * @brief -> operator overload when <const_iter_name>-> is called.
+         * @return current which is a pointer to std::pair of KeyT and ValueT objects
+         */
+        pointer operator->() const
+        {
+            return current;
+        }
+
+        /**
+         * @brief ++ operator overload when ++<const_iter_name> is called.
+         * @return advances the current and indexes to the next item and returns the iterator,
+         * when last is reached points to nullptr.
+         */
+        const_iterator &operator++()
+        {
+            if (ictrl == nullptr)
+            {
+                current = nullptr;
+                return *this;
+            }
+            bucket++;
+            while (bucket < icapacity && !_isFull(ictrl[bucket]))
+            {
+                bucket++;
+            }
+            if (bucket < icapacity)
+            {
+                current = islots + bucket;
+                return *this;
+            }
+            if (inext == nullptr)
+            {
+                current = nullptr;
+                return *this;
+            }
+            bucket = NO_SLOT;
+            icapacity = inext->capacity;
+            ictrl = inext->ctrl;
+            islots = inext->slots;
+            inext = nullptr;
+            return ++(*this);
+        }
+
+        /**
+         * @brief ++ operator overload when <const_iter_name>++ is called.
+         * @return advances the current and indexes to the next item and returns an iterator
+         * pointing to the previous item.
+         */
+        const_iterator operator++(int)
+        {
+            const_iterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        /**
+         * @brief == operator overload when <const_iter_name>==<other_const_iter_name> is called.
+         * @return true if both iterator point to the same pair.
+         */
+        bool operator==(const_iterator const &other) const
+        {
+            return other.current == current;
+        }
+
+        /**
+         * @brief != operator overload when <const_iter_name>==<other_const_iter_name> is called.
+         * @return true if both iterator point to the a different pair.
+         */
+        bool operator!=(const_iterator const &other) const
+        {
+            return other.current != current;
+        }
+    };
+
+    /**
+     * @brief iterator object of HashMap giving access to the values. Keys must not be changed.
+     */
+    class iterator : public const_iterator
+    {
+        friend class HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>;
+
+    public:
+        typedef std::pair<KeyT, ValueT> *pointer;
+
+        typedef std::pair<KeyT, ValueT> &reference;
+
+        /**
+         * @brief Constructor of Iterator, finding first items.
+         * @param first table to iterate over, nullptr for an end iterator.
+         * @param next table to iterate over after first, nullptr if there is none.
+         */
+        iterator(const Table *first, const Table *next) :
+                const_iterator(first, next)
+        {
+        }
+
+        /**
+         * @brief Constructor of Iterator pointing to the item in a given slot.
+         * @param first table holding the item.
+         * @param next table to iterate over after first, nullptr if there is none.
+         * @param slot index of a full slot to point to.
+         */
+        iterator(const Table *first, const Table *next, size_t slot) :
+                const_iterator(first, next, slot)
+        {
+        }
+
+        /**
+         * @brief * operator overload when *<iter_name> is called.
+         * @return dereference of current.
+         */
+        reference operator*() const
+        {
+            return *this->current;
+        }
+
+        /**
+         * @brief -> operator overload when <iter_name>-> is called.
+         * @return current which is a pointer to std::pair of KeyT and ValueT objects
+         */
+        pointer operator->() const
+        {
+            return this->current;
+        }
+
+        /**
+         * @brief ++ operator overload when ++<iter_name> is called.
+         * @return advances to the next item and returns the iterator.
+         */
+        iterator &operator++()
+        {
+            const_iterator::operator++();
+            return *this;
+        }
+
+        /**
+         * @brief ++ operator overload when <iter_name>++ is called.
+         * @return advances to the next item and returns an iterator pointing to the previous item.
+         */
+        iterator operator++(int)
+        {
+            iterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+    private:
+        /**
+         * @brief Constructor of Iterator pointing where a const iterator points.
+         * @param other const iterator into a HashMap this iterator may change.
+         */
+        explicit iterator(const const_iterator &other) :
+                const_iterator(other)
+        {
+        }
+    };
+
+    /**
+     * @return A const iterator pointing to the first item in the HashMap, found in constant
+     * time through the first full slot, which the HashMap keeps track of.
+     */
+    const_iterator begin() const
+    {
+        if (firstFull < table.capacity)
+        {
+            return const_iterator(&table, _migrating() ? &oldTable : nullptr, firstFull);
+        }
+        return const_iterator(_migrating() ? &oldTable : nullptr, nullptr);
+    }
+
+    /**
+     * @return An iterator pointing to the first item in the HashMap.
+     */
+    iterator begin()
+    {
+        return iterator(static_cast<const HashMap *>(this)->begin());
+    }
+
+    /**
+     * @return A const iterator pointing to nullptr.
+     */
+    const_iterator end() const
+    {
+        return const_iterator(nullptr, nullptr);
+    }
+
+    /**
+     * @return An iterator pointing to nullptr.
+     */
+    iterator end()
+    {
+        return iterator(nullptr, nullptr);
+    }
+
+    /**
+     * @return A const iterator pointing to the first item in the HashMap.
+     */
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+
+    /**
+     * @return A const iterator pointing to nullptr.
+     */
+    const_iterator cend() const
+    {
+        return end();
+    }
+
+    /**
+     * @brief Looks for a key, hashing it once and without throwing.
+     * @param key to search for.
+     * @return A const iterator pointing to key's pair, end() if key isn't in the HashMap.
+     */
+    const_iterator find(const KeyT &key) const
+    {
+        return _iteratorAt(_locate(key));
+    }
+
+    /**
+     * @brief Looks for a key, hashing it once and without throwing.
+     * @param key to search for.
+     * @return An iterator pointing to key's pair, end() if key isn't in the HashMap.
+     */
+    iterator find(const KeyT &key)
+    {
+        return iterator(_iteratorAt(_locate(key)));
+    }
+
+    /**
+     * @brief Looks for a key given as another type, e.g. a std::string_view or a const char*
+     * for std::string keys, without constructing a KeyT. Only when lookups are transparent.
+     * @param key object Hash accepts and KeyEqual compares to keys.
+     * @return A const iterator pointing to key's pair, end() if key isn't in the HashMap.
+     */
+    template<class K, class = _transparent<K>>
+    const_iterator find(const K &key) const
+    {
+        return _iteratorAt(_locate(key));
+    }
+
+    /**
+     * @brief Looks for a key given as another type, only when lookups are transparent.
+     * @param key object Hash accepts and KeyEqual compares to keys.
+     * @return An iterator pointing to key's pair, end() if key isn't in the HashMap.
+     */
+    template<class K, class = _transparent<K>>
+    iterator find(const K &key)
+    {
+        return iterator(_iteratorAt(_locate(key)));
+    }
+
+    /**
+     * @brief Erases the pair an iterator points to. Never rehashes, so the other iterators
+     * stay valid and a loop may go on erasing; the HashMap shrinks at a later erasure by key.
+     * @param pos iterator pointing to a pair of this HashMap.
+     * @return An iterator pointing to the pair after the erased one.
+     */
+    iterator erase(const_iterator pos);
+
+    /**
+     * @brief Erases every pair a predicate holds for, going over the slots once, and shrinks
+     * the HashMap once at the end if it became too empty.
+     * @param pred called with a const reference to every pair.
+     * @return number of pairs erased.
+     */
+    template<class Predicate>
+    size_type erase_if(Predicate pred);
+
+    /**
+     * @brief checks if a key given as another type is contained in the HashMap, only when
+     * lookups are transparent.
+     * @param key object Hash accepts and KeyEqual compares to keys.
+     * @return true if the HashMap contains the key, false otherwise.
+     */
+    template<class K, class = _transparent<K>>
+    bool containsKey(const K &key) const
+    {
+        return _locate(key).first != nullptr;
+    }
+
+    /**
+     * @brief Get value by a key given as another type, only when lookups are transparent.
+     * @param key object Hash accepts and KeyEqual compares to keys.
+     * @return reference to ValueT object if HashMap contains key, throws exception otherwise.
+     */
+    template<class K, class = _transparent<K>>
+    ValueT &at(const K &key)
+    {
+        return _valueAt(key);
+    }
+
+    /**
+     * @brief Get value by a key given as another type, only when lookups are transparent.
+     * @param key object Hash accepts and KeyEqual compares to keys.
+     * @return ValueT object if HashMap contains key, throws exception otherwise.
+     */
+    template<class K, class = _transparent<K>>
+    ValueT at(const K &key) const
+    {
+        return _valueAt(key);
+    }
+
+    /**
+     * @brief Counts the pairs of a key given as another type, only when lookups are
+     * transparent.
+     * @param key object Hash accepts and KeyEqual compares to keys.
+     * @return 1 if the HashMap contains the key, 0 otherwise.
+     */
+    template<class K, class = _transparent<K>>
+    size_type count(const K &key) const
+    {
+        return _locate(key).first != nullptr ? 1 : 0;
+    }
+
+private:
+    /**
+     * @param place table and index of a slot as returned by _locate.
+     * @return A const iterator pointing to the slot, end() if place is empty.
+     */
+    const_iterator _iteratorAt(std::pair<const Table *, size_t> place) const
+    {
+        if (place.first == nullptr)
+        {
+            return end();
+        }
+        return const_iterator(place.first, place.first == &table && _migrating() ? &oldTable : nullptr,
+                              place.second);
+    }
+
+public:
+
+    //operators
+
+    /**
+     * @brief = operator overload when <HashMap_name>=<other_HashMap_name> is called,
+     * Copies data from other HashMap to this HashMap.
+     * @return Reference to current HashMap
+     */
+    HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &operator=(const HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &other);
+
+    /**
+     * @brief = operator overload when <HashMap_name>=<rvalue HashMap> is called,
+     * Takes other's pairs without copying them, along with its allocator. An allocator that
+     * doesn't propagate on move assignment and differs from other's can't free other's
+     * arrays, so then other's pairs are moved one by one into arrays of this allocator.
+     * Doesn't throw if the allocator propagates or all its instances are equal, unless
+     * moving a pair or copying the hash or equality object may throw.
+     * @return Reference to current HashMap
+     */
+    HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &operator=(HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &&other)
+    noexcept(nothrowMovable && (allocTraits::propagate_on_container_move_assignment::value ||
+                                allocTraits::is_always_equal::value));
+
+    /**
+     * @brief [] operator overload when <HashMap_name>[KeyT key] is called.
+     * @return Reference to the ValueT item in the key place if it exists,
+     * otherwise inserts default ValueT value and returns reference to it.
+     */
+    ValueT &operator[](const KeyT &key);
+
+    /**
+     * @brief [] operator overload when <HashMap_name>[KeyT key] is called with an rvalue key.
+     * @return Reference to the ValueT item in the key place if it exists,
+     * otherwise moves key in with a default ValueT value and returns reference to it.
+     */
+    ValueT &operator[](KeyT &&key);
+
+    /**
+     * @brief [] operator overload when const <HashMap_name>[KeyT key] is called.
+     * @return Reference to the ValueT item in the key place if it exists,
+     * otherwise returns a reference to default ValueT.
+     */
+    ValueT operator[](const KeyT &key) const;
+
+    /**
+     * @brief == operator overload when const <HashMap_name>==<other_HashMap_name> is called.
+     * @return true if the group of keyT, ValueT pairs in current is
+     * equal to the group of other HashMap, false otherwise.
+     */
+    bool operator==(const HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &other) const;
+
+    /**
+     * @brief != operator overload when const <HashMap_name>!=<other_HashMap_name> is called.
+     * @return true if the group of keyT, ValueT pairs in current is
+     * unequal to the group of other HashMap, false otherwise.
+     */
+    bool operator!=(const HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &other) const;
+};
+
+/**
+ * @brief Default HashMap constructor.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::HashMap():
+        HashMap(Alloc())
+{
+}
+
+/**
+ * @brief HashMap constructor taking its tables from a given allocator.
+ * @param alloc allocator to use.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::HashMap(const Alloc &alloc):
+        HashMap(Hash(), KeyEqual(), alloc)
+{
+}
+
+/**
+ * @brief HashMap constructor with given hash and equality objects.
+ * @param hash hash of keys.
+ * @param equal equality of keys.
+ * @param alloc allocator to use.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::HashMap(const Hash &hash, const KeyEqual &equal, const Alloc &alloc):
+        numOfPairs(0),
+        tombstones(0),
+        firstFull(0),
+        oldCount(0),
+        migrated(0),
+        incremental(false),
+        rehashThreads(1),
+        upperLoadFactor(DEFAULT_UPPER_LOAD_FACTOR),
+        lowerLoadFactor(DEFAULT_LOWER_LOAD_FACTOR),
+        minCapacity(INLINE_CAPACITY),
+        hasher(hash),
+        keyEqual(equal),
+        allocator(alloc)
+{
+    table = _allocate(INLINE_CAPACITY);
+    firstFull = table.capacity;
+}
+
+/**
+ * @brief Constructor that receives values in two separate vectors.
+ * @param keys const reference to KeyT object vector.
+ * @param values const reference to ValueT object vector.
+ * @param alloc allocator to use.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::HashMap(const std::vector<KeyT> &keys,
+                                                     const std::vector<ValueT> &values, const Alloc &alloc):
+        HashMap(alloc)
+{
+    // The delegating constructor finished, so the destructor releases the map on a throw.
+    if (keys.size() != values.size())
+    {
+        throw std::runtime_error("Vector lengths aren't equal");
+    }
+    reserve(keys.size());
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        (*this)[keys[i]] = values[i];
+    }
+}
+
+/**
+ * @brief Constructor that receives values in two separate vectors and inserts them on
+ * several threads, each owning a range of the slots. Holds the same pairs as the
+ * serial constructor, and keeps using threads for its rehashes.
+ * @param keys const reference to KeyT object vector.
+ * @param values const reference to ValueT object vector.
+ * @param threads number of threads to use, as in setParallelRehash.
+ * @param alloc allocator to use.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::HashMap(const std::vector<KeyT> &keys,
+                                                     const std::vector<ValueT> &values, unsigned int threads,
+                                                     const Alloc &alloc):
+        HashMap(alloc)
+{
+    // The delegating constructor finished, so the destructor releases the map on a throw.
+    if (keys.size() != values.size())
+    {
+        throw std::runtime_error("Vector lengths aren't equal");
+    }
+    setParallelRehash(threads);
+    reserve(keys.size());
+    unsigned int buildThreads = _parallelThreads(keys.size());
+    if (buildThreads > 1)
+    {
+        _parallelBuild(keys, values, buildThreads);
+    }
+    else
+    {
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            (*this)[keys[i]] = values[i];
+        }
+    }
+}
+
+/**
+ * @brief Copy constructor
+ * @param other HashMap to copy.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::HashMap(const HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &other):
+        numOfPairs(0),
+        tombstones(0),
+        firstFull(0),
+        oldCount(0),
+        migrated(0),
+        incremental(other.incremental),
+        rehashThreads(other.rehashThreads),
+        upperLoadFactor(other.upperLoadFactor),
+        lowerLoadFactor(other.lowerLoadFactor),
+        minCapacity(other.minCapacity),
+        hasher(other.hasher),
+        keyEqual(other.keyEqual),
+        allocator(allocTraits::select_on_container_copy_construction(other.allocator))
+{
+    _copyFrom(other);
+}
+
+/**
+ * @brief Move constructor, takes other's pairs without copying them. Doesn't throw
+ * unless moving a pair or copying the hash or equality object may throw.
+ * @param other HashMap to move from, left as a valid empty HashMap.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::HashMap(HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &&other)
+noexcept(nothrowMovable):
+        HashMap(other.hasher, other.keyEqual, other.allocator)
+{
+    _moveFrom(other);
+}
+
+//private funcs
+/**
+ * @brief hashes given key, mixing the bits so both the fragment and the home slot
+ * depend on the whole hash.
+ * @param key KeyT object, or object Hash accepts if lookups are transparent, to hash.
+ * @return full hash of key.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+template<class K>
+size_t HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_hash(const K &key) const
+{
+    size_t hash = hasher(key);
+    return IsAvalanching<Hash>::value ? hash : IntegerHash()(hash);
+}
+
+/**
+ * @brief Looks for a key in both tables.
+ * @param key KeyT object, or object KeyEqual compares to keys if lookups are transparent.
+ * @return table and index of the slot holding key, nullptr and NO_SLOT if key isn't in the HashMap.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+template<class K>
+std::pair<const typename HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::Table *, size_t>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_locate(const K &key) const
+{
+    return _locate(key, _hash(key));
+}
+
+/**
+ * @brief Looks for a key in both tables, given its hash.
+ * @param key KeyT object, or object KeyEqual compares to keys if lookups are transparent.
+ * @param hash full hash of key.
+ * @return table and index of the slot holding key, nullptr and NO_SLOT if key isn't in the HashMap.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+template<class K>
+std::pair<const typename HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::Table *, size_t>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_locate(const K &key, size_t hash) const
+{
+    size_t place = table.find(key, hash, keyEqual);
+    if (place != NO_SLOT)
+    {
+        return std::make_pair(&table, place);
+    }
+    if (_migrating() && (place = oldTable.find(key, hash, keyEqual)) != NO_SLOT)
+    {
+        return std::make_pair(&oldTable, place);
+    }
+    return std::make_pair((const Table *) nullptr, NO_SLOT);
+}
+
+/**
+ * @brief Get value by key.
+ * @param key KeyT object, or object KeyEqual compares to keys if lookups are transparent.
+ * @return reference to ValueT object if HashMap contains key, throws exception otherwise.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+template<class K>
+ValueT &HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_valueAt(const K &key) const
+{
+    std::pair<const Table *, size_t> place = _locate(key);
+    if (place.first == nullptr)
+    {
+        throw std::out_of_range(KEY_DOES_NOT_EXIST);
+    }
+    return place.first->slots[place.second].second;
+}
+
+/**
+ * @param group pointer to GROUP_WIDTH control bytes.
+ * @param c control byte to look for.
+ * @return bit mask with bit i set if group[i] equals c.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+unsigned int HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_matchByte(const signed char *group, signed char c)
+{
+#if defined(__AVX2__)
+    __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(group));
+    return (unsigned int) _mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(c)));
+#elif defined(__SSE2__)
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+    return (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(c)));
+#else
+    unsigned int match = 0;
+    for (size_t i = 0; i < GROUP_WIDTH; i++)
+    {
+        match |= (unsigned int) (group[i] == c) << i;
+    }
+    return match;
+#endif
+}
+
+/**
+ * @param group pointer to GROUP_WIDTH control bytes.
+ * @return bit mask with bit i set if group[i] is empty or deleted.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+unsigned int HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_matchFree(const signed char *group)
+{
+    // Empty and deleted are the only negative control bytes.
+#if defined(__AVX2__)
+    return (unsigned int) _mm256_movemask_epi8(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(group)));
+#elif defined(__SSE2__)
+    return (unsigned int) _mm_movemask_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(group)));
+#else
+    unsigned int match = 0;
+    for (size_t i = 0; i < GROUP_WIDTH; i++)
+    {
+        match |= (unsigned int) (group[i] < 0) << i;
+    }
+    return match;
+#endif
+}
+
+/**
+ * @brief Allocates empty control bytes and slots for capacity slots, using the inline
+ * arrays when they are big enough and no table uses them.
+ * @param capacity number of slots to allocate, at least INLINE_CAPACITY.
+ * @return table holding the new arrays.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+typename HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::Table HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_allocate(size_t capacity)
+{
+    Table fresh;
+    if (capacity <= INLINE_CAPACITY && !_isInline(table) && !_isInline(oldTable))
+    {
+        capacity = INLINE_CAPACITY;
+        fresh.slots = reinterpret_cast<pairType *>(inlineSlots);
+        fresh.hashes = inlineHashes;
+        fresh.ctrl = inlineCtrl;
+    }
+    else
+    {
+        pairAlloc slotAllocator(allocator);
+        hashAlloc hashAllocator(allocator);
+        ctrlAlloc ctrlAllocator(allocator);
+        fresh.slots = std::allocator_traits<pairAlloc>::allocate(slotAllocator, capacity);
+        try
+        {
+            fresh.hashes = std::allocator_traits<hashAlloc>::allocate(hashAllocator, capacity);
+            fresh.ctrl = std::allocator_traits<ctrlAlloc>::allocate(ctrlAllocator, capacity + GROUP_WIDTH);
+        }
+        catch (...)
+        {
+            // Give back the arrays already allocated, nothing holds them yet.
+            if (fresh.hashes != nullptr)
+            {
+                std::allocator_traits<hashAlloc>::deallocate(hashAllocator, fresh.hashes, capacity);
+            }
+            std::allocator_traits<pairAlloc>::deallocate(slotAllocator, fresh.slots, capacity);
+            throw;
+        }
+    }
+    for (size_t i = 0; i < capacity + GROUP_WIDTH; i++)
+    {
+        fresh.ctrl[i] = EMPTY_SLOT;
+    }
+    fresh.capacity = capacity;
+    return fresh;
+}
+
+/**
+ * @brief Destroys all pairs and frees control bytes and slots of both tables.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_release()
+{
+    _destroyAll(table);
+    _deallocate(table);
+    if (_migrating())
+    {
+        _destroyAll(oldTable);
+        _deallocate(oldTable);
+    }
+}
+
+/**
+ * @brief Gives the arrays of a table back to the allocator, or the inline arrays back to
+ * this HashMap, leaving the table without arrays. Does nothing to a table without arrays.
+ * @param old table whose pairs were all destroyed.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_deallocate(Table &old)
+{
+    if (_isInline(old) || old.ctrl == nullptr)
+    {
+        old = Table();
+        return;
+    }
+    pairAlloc slotAllocator(allocator);
+    hashAlloc hashAllocator(allocator);
+    ctrlAlloc ctrlAllocator(allocator);
+    std::allocator_traits<ctrlAlloc>::deallocate(ctrlAllocator, old.ctrl, old.capacity + GROUP_WIDTH);
+    std::allocator_traits<hashAlloc>::deallocate(hashAllocator, old.hashes, old.capacity);
+    std::allocator_traits<pairAlloc>::deallocate(slotAllocator, old.slots, old.capacity);
+    old = Table();
+}
+
+/**
+ * @brief Takes all pairs and settings of another HashMap, moving the pairs of an inline
+ * table one by one and stealing the arrays of any other table. This HashMap must be
+ * empty, without an incremental rehash running.
+ * @param other HashMap to move from, left as a valid empty HashMap.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_moveFrom(HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &other)
+{
+    if (other._isInline(other.oldTable))
+    {
+        other._migrate(other.oldTable.capacity);
+    }
+    _deallocate(table);
+    if (other._isInline(other.table))
+    {
+        table = _allocate(INLINE_CAPACITY);
+        for (size_t i = 0; i < INLINE_CAPACITY; i++)
+        {
+            if (_isFull(other.table.ctrl[i]))
+            {
+                new(table.slots + i) pairType(std::move(other.table.slots[i]));
+                other.table.slots[i].~pairType();
+                table.hashes[i] = other.table.hashes[i];
+                table.setCtrl(i, other.table.ctrl[i]);
+            }
+        }
+        other._deallocate(other.table);
+    }
+    else
+    {
+        table = other.table;
+    }
+    oldTable = other.oldTable;
+    other.oldTable = Table();
+    other.table = other._allocate(INLINE_CAPACITY);
+    numOfPairs = other.numOfPairs;
+    tombstones = other.tombstones;
+    firstFull = other.firstFull;
+    oldCount = other.oldCount;
+    migrated = other.migrated;
+    incremental = other.incremental;
+    rehashThreads = other.rehashThreads;
+    upperLoadFactor = other.upperLoadFactor;
+    lowerLoadFactor = other.lowerLoadFactor;
+    minCapacity = other.minCapacity;
+    hasher = other.hasher;
+    keyEqual = other.keyEqual;
+    allocator = other.allocator;
+    other.numOfPairs = 0;
+    other.tombstones = 0;
+    other.firstFull = other.table.capacity;
+    other.oldCount = 0;
+    other.minCapacity = INLINE_CAPACITY;
+}
+
+/**
+ * @brief Destroys every pair in a table.
+ * @param old table to destroy the pairs of.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_destroyAll(const Table &old)
+{
+    if (std::is_trivially_destructible<pairType>::value)
+    {
+        return;
+    }
+    for (size_t i = 0; i < old.capacity; i++)
+    {
+        if (_isFull(old.ctrl[i]))
+        {
+            old.slots[i].~pairType();
+        }
+    }
+}
+
+/**
+ * @brief Copies every pair of another HashMap into this empty one.
+ * @param other HashMap to copy.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_copyFrom(const HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &other)
+{
+    table = _allocate(other.table.capacity);
+    const Table *sources[] = {&other.table, &other.oldTable};
+    for (const Table *source: sources)
+    {
+        for (size_t i = 0; i < source->capacity; i++)
+        {
+            if (_isFull(source->ctrl[i]))
+            {
+                size_t place = table.findFree(source->hashes[i]);
+                new(table.slots + place) pairType(source->slots[i]);
+                table.hashes[place] = source->hashes[i];
+                table.setCtrl(place, source->ctrl[i]);
+                numOfPairs++;
+            }
+        }
+    }
+    _findFirstFull(0);
+}
+
+/**
+ * @brief HashMap destructor.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::~HashMap()
+{
+    _release();
+}
+
+
+/**
+ * @brief inserts a new value to the HashMap at a certain key location.
+ * @param key to locate value by.
+ * @param val value to input in the HashMap.
+ * @return true if insertion was successful, false otherwise.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+bool HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::insert(const KeyT &key, const ValueT &val)
+{
+    return _tryEmplace(key, val).second;
+}
+
+/**
+ * @brief inserts a new value to the HashMap at a certain key location, moving both.
+ * @param key to locate value by.
+ * @param val value to input in the HashMap.
+ * @return true if insertion was successful, false otherwise.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+bool HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::insert(KeyT &&key, ValueT &&val)
+{
+    return _tryEmplace(std::move(key), std::move(val)).second;
+}
+
+/**
+ * @brief builds a KeyT, ValueT pair from args and moves it into the HashMap.
+ * @param args arguments of a std::pair<KeyT, ValueT> constructor.
+ * @return true if insertion was successful, false if the key was already in the HashMap.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+template<class... Args>
+bool HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::emplace(Args &&... args)
+{
+    // The key is needed before a slot can be chosen, so the pair is built aside once.
+    pairType pair(std::forward<Args>(args)...);
+    return _tryEmplace(std::move(pair.first), std::move(pair.second)).second;
+}
+
+/**
+ * @brief constructs a value from args in place if key isn't in the HashMap,
+ * args are left untouched otherwise.
+ * @param key to locate value by.
+ * @param args arguments of a ValueT constructor.
+ * @return true if insertion was successful, false if the key was already in the HashMap.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+template<class... Args>
+bool HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::try_emplace(const KeyT &key, Args &&... args)
+{
+    return _tryEmplace(key, std::forward<Args>(args)...).second;
+}
+
+/**
+ * @brief constructs a value from args in place if key isn't in the HashMap, moving key
+ * into it. Key and args are left untouched otherwise.
+ * @param key to locate value by.
+ * @param args arguments of a ValueT constructor.
+ * @return true if insertion was successful, false if the key was already in the HashMap.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+template<class... Args>
+bool HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::try_emplace(KeyT &&key, Args &&... args)
+{
+    return _tryEmplace(std::move(key), std::forward<Args>(args)...).second;
+}
+
+/**
+ * @return true if one more pair fits in table without growing or cleaning tombstones.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+bool HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_fitsOneMore() const
+{
+    return (double) (numOfPairs + 1) / table.capacity <= upperLoadFactor &&
+           (double) (numOfPairs - oldCount + tombstones + 1) / table.capacity <= upperLoadFactor;
+}
+
+/**
+ * @brief Grows the HashMap, or cleans its tombstones, if one more pair would not fit. Too
+ * many tombstones are cleaned in place only while the live load factor is at most half the
+ * upper one, or twice the lower one if that is more, otherwise the HashMap grows.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_makeRoomForOne()
+{
+    if ((double) (numOfPairs + 1) / table.capacity > upperLoadFactor)
+    {
+        _resize(table.capacity * 2);
+    }
+    else if ((double) (numOfPairs - oldCount + tombstones + 1) / table.capacity > upperLoadFactor)
+    {
+        // Too few empty slots left to end probe sequences. Past half the upper load factor,
+        // cleaning tombstones in place soon ends in growing anyway, a second rehash in a row,
+        // so grow now, unless doubling would leave the HashMap below its lower load factor.
+        double cleanLimit = std::max(upperLoadFactor / 2, 2 * lowerLoadFactor);
+        _resize((double) (numOfPairs + 1) / table.capacity > cleanLimit ? table.capacity * 2 : table.capacity);
+    }
+}
+
+/**
+ * @brief Looks for key and constructs a new pair for it in place if it is missing.
+ * @param key to look for, forwarded to the new pair's key.
+ * @param args forwarded to the new pair's value constructor.
+ * @return index of the slot in table holding key and true if a new pair was constructed.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+template<class K, class... Args>
+std::pair<size_t, bool> HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_tryEmplace(K &&key, Args &&... args)
+{
+    size_t hash = _hash(key);
+    return _tryEmplaceHashed(hash, std::forward<K>(key), std::forward<Args>(args)...);
+}
+
+/**
+ * @brief Looks for key, given its hash, and constructs a new pair for it in place if it
+ * is missing.
+ * key and args may refer to pairs of this HashMap, as in m.insert(k, m.at(j)), so the new
+ * pair is built before any pair is moved: in its slot when nothing has to move, and aside,
+ * to be moved in afterwards, when a migration step or a rehash has to run first.
+ * @param hash full hash of key.
+ * @param key to look for, forwarded to the new pair's key.
+ * @param args forwarded to the new pair's value constructor.
+ * @return index of the slot in table holding key and true if a new pair was constructed.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+template<class K, class... Args>
+std::pair<size_t, bool> HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_tryEmplaceHashed(size_t hash, K &&key,
+                                                                                      Args &&... args)
+{
+    size_t place = _findForUpdate(key, hash);
+    if (place != NO_SLOT)
+    {
+        _migrate(MIGRATION_STEP);
+        return std::make_pair(place, false);
+    }
+    if (!_migrating() && _fitsOneMore())
+    {
+        place = table.findFree(hash);
+        new(table.slots + place) pairType(std::piecewise_construct,
+                                          std::forward_as_tuple(std::forward<K>(key)),
+                                          std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+    else
+    {
+        alignas(pairType) unsigned char buffer[sizeof(pairType)];
+        pairType *staged = new(buffer) pairType(std::piecewise_construct,
+                                                std::forward_as_tuple(std::forward<K>(key)),
+                                                std::forward_as_tuple(std::forward<Args>(args)...));
+        try
+        {
+            _migrate(MIGRATION_STEP);
+            _makeRoomForOne();
+            place = table.findFree(hash);
+            new(table.slots + place) pairType(std::move(*staged));
+        }
+        catch (...)
+        {
+            staged->~pairType();
+            throw;
+        }
+        staged->~pairType();
+    }
+    if (table.ctrl[place] == DELETED_SLOT)
+    {
+        tombstones--;
+    }
+    table.hashes[place] = hash;
+    table.setCtrl(place, _fragment(hash));
+    numOfPairs++;
+    firstFull = std::min(firstFull, place);
+    return std::make_pair(place, true);
+}
+
+/**
+ * @brief Looks for key to change it, moving it to table first if it is in oldTable.
+ * @param key to search for.
+ * @param hash full hash of key.
+ * @return index of the slot in table holding key, NO_SLOT if key isn't in the HashMap.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+size_t HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_findForUpdate(const KeyT &key, size_t hash)
+{
+    size_t place = table.find(key, hash, keyEqual);
+    if (place != NO_SLOT || !_migrating())
+    {
+        return place;
+    }
+    place = oldTable.find(key, hash, keyEqual);
+    return place == NO_SLOT ? NO_SLOT : _migrateSlot(place);
+}
+
+/**
+ * @brief Rehashes all keys in the HashMap to new HashMap of newCapacity capacity,
+ * using the stored hashes.
+ * @param newCapacity number of buckets after operation is done.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_reHash(size_t newCapacity)
+{
+    Table fresh = _allocate(newCapacity);
+    Table *sources[] = {&table, &oldTable};
+    unsigned int threads = _parallelThreads(numOfPairs);
+    if (threads > 1 && std::is_nothrow_move_constructible<pairType>::value)
+    {
+        try
+        {
+            _parallelMoveIn(fresh, threads);
+        }
+        catch (...)
+        {
+            _deallocate(fresh);
+            throw;
+        }
+    }
+    else
+    {
+        for (Table *source: sources)
+        {
+            for (size_t i = 0; i < source->capacity; ++i)
+            {
+                if (_isFull(source->ctrl[i]))
+                {
+                    fresh.moveIn(source->slots[i], source->hashes[i]);
+                    source->slots[i].~pairType();
+                }
+            }
+        }
+    }
+    for (Table *source: sources)
+    {
+        if (source->ctrl != nullptr)
+        {
+            _deallocate(*source);
+        }
+    }
+    table = fresh;
+    tombstones = 0;
+    oldCount = 0;
+    _findFirstFull(0);
+}
 
-    /**
-     * @brief != operator overload when const <HashMap_name>!=<other_HashMap_name> is called.
-     * @return true if the group of keyT, ValueT pairs in current is
-     * unequal to the group of other HashMap, false otherwise.
-     */
-    bool operator!=(const HashMap<KeyT, ValueT> &other) const;
-};
+/**
+ * @brief Sets firstFull to the first full slot of table from a given slot on.
+ * @param from slot to start at, no slot before it may be full.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_findFirstFull(size_t from)
+{
+    for (firstFull = from; firstFull < table.capacity; firstFull += GROUP_WIDTH)
+    {
+        // Bits past the last slot stand for clones of the first slots, which come earlier.
+        unsigned int full = ~_matchFree(table.ctrl + firstFull) & (~0u >> (32 - GROUP_WIDTH));
+        if (full != 0)
+        {
+            firstFull = std::min(firstFull + __builtin_ctz(full), table.capacity);
+            return;
+        }
+    }
+    firstFull = table.capacity;
+}
 
 /**
- * @brief Default HashMap constructor.
+ * @brief Starts an incremental rehash, turning table to oldTable.
+ * @param newCapacity number of buckets in the new table.
  */
-template<class KeyT, class ValueT>
-HashMap<KeyT, ValueT>::HashMap():
-        maxCapacity(DEFAULT_CAPACITY),
-        count(0),
-        vec(new pairVector[DEFAULT_CAPACITY])
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_startMigration(size_t newCapacity)
 {
+    Table fresh = _allocate(newCapacity);
+    oldTable = table;
+    oldCount = numOfPairs;
+    migrated = 0;
+    table = fresh;
+    tombstones = 0;
+    firstFull = table.capacity;
 }
 
 /**
- * @brief Constructor that receives values in two separate vectors.
- * @param keys const reference to KeyT object vector.
- * @param values const reference to ValueT object vector.
+ * @brief Rehashes to newCapacity buckets, at once, or in incremental mode by finishing a
+ * running migration and starting a new one.
+ * @param newCapacity number of buckets after operation is done.
  */
-template<class KeyT, class ValueT>
-HashMap<KeyT, ValueT>::HashMap(const std::vector<KeyT> &keys, const std::vector<ValueT> &values):
-        maxCapacity(DEFAULT_CAPACITY),
-        count(0)
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_resize(size_t newCapacity)
 {
-    if (keys.size() != values.size())
+    if (!incremental)
     {
-        throw std::runtime_error("Vector lengths aren't equal");
+        _reHash(newCapacity);
+        return;
     }
-    vec = new pairVector[maxCapacity];
-    for (size_t i = 0; i < keys.size(); i++)
+    _migrate(oldTable.capacity);
+    _startMigration(newCapacity);
+}
+
+/**
+ * @brief Moves the pairs of both tables to an empty table on several threads, each
+ * thread owning a range of the new table's slots. Pairs must be nothrow movable, so it
+ * throws only before moving any pair.
+ * @param fresh table to move the pairs to, without deleted slots.
+ * @param threads number of threads, the calling thread included.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_parallelMoveIn(Table &fresh, unsigned int threads)
+{
+    size_t regions = _numOfRegions(fresh.capacity, threads), regionSize = fresh.capacity / regions;
+    size_t total = table.capacity + oldTable.capacity;
+    Table *sources[] = {&table, &oldTable};
+    // staged[t * regions + r] lists, in order, the slots thread t found whose pairs go to region r.
+    // Slots are numbered over table and then oldTable.
+    std::vector<std::vector<size_t>> staged((size_t) threads * regions);
+    _parallelFor(threads, [&](unsigned int t)
     {
-        (*this)[keys[i]] = values[i];
+        for (size_t i = total * t / threads; i < total * (t + 1) / threads; i++)
+        {
+            const Table &source = *sources[i < table.capacity ? 0 : 1];
+            size_t slot = i < table.capacity ? i : i - table.capacity;
+            if (_isFull(source.ctrl[slot]))
+            {
+                staged[t * regions + fresh.home(source.hashes[slot]) / regionSize].push_back(i);
+            }
+        }
+    });
+    // Pairs whose probe sequence leaves their region stay staged for the calling thread.
+    _parallelFor(threads, [&](unsigned int t)
+    {
+        for (size_t r = t; r < regions; r += threads)
+        {
+            for (size_t from = 0; from < threads; from++)
+            {
+                std::vector<size_t> &list = staged[from * regions + r];
+                size_t left = 0;
+                for (size_t i: list)
+                {
+                    Table &source = *sources[i < table.capacity ? 0 : 1];
+                    size_t slot = i < table.capacity ? i : i - table.capacity;
+                    size_t place = fresh.probeRange(source.hashes[slot], (r + 1) * regionSize, nullptr, keyEqual);
+                    if (place == NO_SLOT)
+                    {
+                        list[left++] = i;
+                        continue;
+                    }
+                    new(fresh.slots + place) pairType(std::move(source.slots[slot]));
+                    source.slots[slot].~pairType();
+                    fresh.hashes[place] = source.hashes[slot];
+                    fresh.setCtrl(place, _fragment(source.hashes[slot]));
+                }
+                list.resize(left);
+            }
+        }
+    });
+    for (const std::vector<size_t> &list: staged)
+    {
+        for (size_t i: list)
+        {
+            Table &source = *sources[i < table.capacity ? 0 : 1];
+            size_t slot = i < table.capacity ? i : i - table.capacity;
+            fresh.moveIn(source.slots[slot], source.hashes[slot]);
+            source.slots[slot].~pairType();
+        }
     }
 }
 
 /**
- * @brief Copy constructor
- * @param other HashMap to copy.
+ * @brief Inserts the pairs of two vectors on several threads, each thread owning a
+ * range of table's slots. A later pair of a repeated key replaces the earlier one.
+ * table must be big enough for all pairs and have no deleted slots.
+ * @param keys keys to insert.
+ * @param values values of the keys.
+ * @param threads number of threads, the calling thread included.
  */
-template<class KeyT, class ValueT>
-HashMap<KeyT, ValueT>::HashMap(HashMap<KeyT, ValueT> &other):
-        maxCapacity(other.maxCapacity), count(other.count), vec(new pairVector[maxCapacity])
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_parallelBuild(const std::vector<KeyT> &keys,
+                                                                 const std::vector<ValueT> &values,
+                                                                 unsigned int threads)
 {
-    for (int i = 0; i < maxCapacity; i++)
+    size_t regions = _numOfRegions(table.capacity, threads), regionSize = table.capacity / regions;
+    std::vector<size_t> hashes(keys.size()), inserted(threads, 0);
+    // staged[t * regions + r] lists, in order, the indexes thread t found whose keys go to region r.
+    std::vector<std::vector<size_t>> staged((size_t) threads * regions);
+    _parallelFor(threads, [&](unsigned int t)
+    {
+        for (size_t i = keys.size() * t / threads; i < keys.size() * (t + 1) / threads; i++)
+        {
+            hashes[i] = _hash(keys[i]);
+            staged[t * regions + table.home(hashes[i]) / regionSize].push_back(i);
+        }
+    });
+    // Equal keys share a region, which a single thread goes over in index order, so the
+    // last value of a key wins as in the serial constructor. A key whose probe sequence
+    // leaves its region stays staged, and so does every later copy of it.
+    _parallelFor(threads, [&](unsigned int t)
+    {
+        for (size_t r = t; r < regions; r += threads)
+        {
+            for (size_t from = 0; from < threads; from++)
+            {
+                std::vector<size_t> &list = staged[from * regions + r];
+                size_t left = 0;
+                for (size_t i: list)
+                {
+                    size_t place = table.probeRange(hashes[i], (r + 1) * regionSize, &keys[i], keyEqual);
+                    if (place == NO_SLOT)
+                    {
+                        list[left++] = i;
+                    }
+                    else if (_isFull(table.ctrl[place]))
+                    {
+                        table.slots[place].second = values[i];
+                    }
+                    else
+                    {
+                        new(table.slots + place) pairType(keys[i], values[i]);
+                        table.hashes[place] = hashes[i];
+                        table.setCtrl(place, _fragment(hashes[i]));
+                        inserted[t]++;
+                    }
+                }
+                list.resize(left);
+            }
+        }
+    });
+    for (size_t count: inserted)
     {
-        vec[i] = other.vec[i];
+        numOfPairs += count;
+    }
+    _findFirstFull(0);
+    for (size_t r = 0; r < regions; r++)
+    {
+        for (size_t from = 0; from < threads; from++)
+        {
+            for (size_t i: staged[from * regions + r])
+            {
+                size_t place = _tryEmplaceHashed(hashes[i], keys[i]).first;
+                table.slots[place].second = values[i];
+            }
+        }
     }
 }
 
-//private funcs
 /**
- * @brief hashes given key to index number between 0 and maxCapcity.
- * @param key KeyT object to hash.
- * @return number between 0 and maxCapacity.
+ * @brief Calls work(0), ..., work(threads - 1) on threads threads, the calling thread
+ * being one of them, and waits for all. A thread that can't be started, for any reason,
+ * leaves its work to the calling thread.
+ * @param threads number of calls.
+ * @param work called with the index of the call, its exceptions are rethrown once all
+ * calls are done.
  */
-template<class KeyT, class ValueT>
-int HashMap<KeyT, ValueT>::_hash(const KeyT &key) const
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+template<class Function>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_parallelFor(unsigned int threads, Function work)
 {
-    int hash = std::hash<KeyT>()(key);
-    return hash & (maxCapacity - 1);
+    std::vector<std::exception_ptr> errors(threads);
+    auto run = [&work, &errors](unsigned int t)
+    {
+        try
+        {
+            work(t);
+        }
+        catch (...)
+        {
+            errors[t] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    unsigned int started = 1;
+    try
+    {
+        for (; started < threads; started++)
+        {
+            workers.emplace_back(run, started);
+        }
+    }
+    catch (...)
+    {
+        // Whether std::system_error or std::bad_alloc kept a thread from starting, the
+        // calling thread does its work, so nothing is thrown while started threads run.
+    }
+    for (unsigned int t = started; t < threads; t++)
+    {
+        run(t);
+    }
+    run(0);
+    for (std::thread &worker: workers)
+    {
+        worker.join();
+    }
+    for (const std::exception_ptr &error: errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
 }
 
 /**
- * @brief HashMap destructor.
+ * @param items number of pairs.
+ * @return smallest capacity holding items pairs without growing.
  */
-template<class KeyT, class ValueT>
-HashMap<KeyT, ValueT>::~HashMap()
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+size_t HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_fitCapacity(size_t items) const
 {
-    delete[] vec;
+    size_t fit = INLINE_CAPACITY;
+    while ((double) items / fit > upperLoadFactor)
+    {
+        fit *= 2;
+    }
+    return fit;
 }
 
-
 /**
- * @brief inserts a new value to the HashMap at a certain key location.
- * @param key to locate value by.
- * @param val value to input in the HashMap.
- * @return true if insertion was successful, false otherwise.
+ * @brief Moves pairs of oldTable to table, freeing oldTable once it is empty.
+ * @param steps maximal number of oldTable slots to go over.
  */
-template<class KeyT, class ValueT>
-bool HashMap<KeyT, ValueT>::insert(const KeyT &key, const ValueT &val)
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_migrate(size_t steps)
 {
-    if (containsKey(key))
+    if (!_migrating())
     {
-        return false;
+        return;
     }
-    int place = _hash(key);
-    count++;
-    vec[place].push_back(std::make_pair(key, val));
-    if (getLoadFactor() > UPPER_LOAD_FACTOR)
+    for (; steps > 0 && oldCount > 0 && migrated < oldTable.capacity; steps--, migrated++)
     {
-        _reHash(maxCapacity * 2);
+        if (_isFull(oldTable.ctrl[migrated]))
+        {
+            _migrateSlot(migrated);
+        }
+    }
+    if (oldCount == 0)
+    {
+        _deallocate(oldTable);
     }
-    return true;
 }
 
 /**
- * @brief Rehashes all keys in the HashMap to new HashMap of newCapacity capacity.
- * @param newCapacity number of buckets after operation is done.
+ * @brief Moves the pair in a slot of oldTable to table.
+ * @param slot index of a full slot of oldTable.
+ * @return index of the slot in table the pair was moved to.
  */
-template<class KeyT, class ValueT>
-void HashMap<KeyT, ValueT>::_reHash(int newCapacity)
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+size_t HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::_migrateSlot(size_t slot)
 {
-    auto newVec = new pairVector[newCapacity];
-    int oldCapacity = maxCapacity;
-    maxCapacity = newCapacity;
-    for (int i = 0; i < oldCapacity; ++i)
+    size_t place = table.findFree(oldTable.hashes[slot]);
+    if (table.ctrl[place] == DELETED_SLOT)
     {
-        for (auto &pair: vec[i])
-        {
-            newVec[_hash(pair.first)].push_back(pair);
-        }
+        tombstones--;
     }
-    delete[] vec;
-    vec = newVec;
+    table.moveTo(place, oldTable.slots[slot], oldTable.hashes[slot]);
+    firstFull = std::min(firstFull, place);
+    oldTable.slots[slot].~pairType();
+    // Other keys of oldTable may still be probed for through this slot.
+    oldTable.setCtrl(slot, DELETED_SLOT);
+    oldCount--;
+    return place;
 }
 
 /**
- * @brief count getter.
+ * @brief numOfPairs getter.
  * @return number of items in HashMap.
  */
-template<class KeyT, class ValueT>
-int HashMap<KeyT, ValueT>::size() const
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+typename HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::size_type HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::size() const
 {
-    return count;
+    return numOfPairs;
 }
 
 /**
- * maxCapacity getter.
+ * capacity getter.
  * @return number of buckets in HashMap.
  */
-template<class KeyT, class ValueT>
-int HashMap<KeyT, ValueT>::capacity() const
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+typename HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::size_type HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::capacity() const
 {
-    return maxCapacity;
+    return table.capacity;
 }
 
 /**
  * @brief checks if the HashMap is empty.
  * @return true if the HashMap is empty, false otherwise.
  */
-template<class KeyT, class ValueT>
-bool HashMap<KeyT, ValueT>::empty() const
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+bool HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::empty() const
 {
-    return count == 0;
+    return numOfPairs == 0;
 }
 
 /**
@@ -512,18 +2443,21 @@ bool HashMap<KeyT, ValueT>::empty() const
  * @param key the key to search for.
  * @return true if the HashMap contains the key, false otherwise.
  */
-template<class KeyT, class ValueT>
-bool HashMap<KeyT, ValueT>::containsKey(const KeyT &key) const
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+bool HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::containsKey(const KeyT &key) const
 {
-    int place = _hash(key);
-    for (auto &pair: vec[place])
-    {
-        if (pair.first == key)
-        {
-            return true;
-        }
-    }
-    return false;
+    return _locate(key).first != nullptr;
+}
+
+/**
+ * @brief Counts the pairs of a key.
+ * @param key the key to search for.
+ * @return 1 if the HashMap contains the key, 0 otherwise.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+typename HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::size_type HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::count(const KeyT &key) const
+{
+    return _locate(key).first != nullptr ? 1 : 0;
 }
 
 /**
@@ -531,69 +2465,159 @@ bool HashMap<KeyT, ValueT>::containsKey(const KeyT &key) const
  * @param key to search by.
  * @return reference to ValueT object if HashMap contains key, throws exception otherwise.
  */
-template<class KeyT, class ValueT>
-ValueT &HashMap<KeyT, ValueT>::at(const KeyT &key)
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+ValueT &HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::at(const KeyT &key)
+{
+    return _valueAt(key);
+}
+
+/**
+ * @brief Get value by key.
+ * @param key to search by.
+ * @return ValueT object if HashMap contains key, throws exception otherwise.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+ValueT HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::at(const KeyT &key) const
+{
+    return _valueAt(key);
+}
+
+/**
+ * @brief Erases key and value from HashMap.
+ * @param key to erase.
+ * @return true if erasure was successful, false otherwise.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+bool HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::erase(const KeyT &key)
 {
-    int place = _hash(key);
-    for (auto &i: vec[place])
+    size_t hash = _hash(key);
+    _migrate(MIGRATION_STEP);
+    size_t place = table.find(key, hash, keyEqual);
+    if (place != NO_SLOT)
+    {
+        if (table.clearSlot(place))
+        {
+            tombstones++;
+        }
+        if (place == firstFull)
+        {
+            _findFirstFull(place + 1);
+        }
+    }
+    else if (_migrating() && (place = oldTable.find(key, hash, keyEqual)) != NO_SLOT)
     {
-        if (i.first == key)
+        oldTable.clearSlot(place);
+        if (--oldCount == 0)
         {
-            return i.second;
+            _deallocate(oldTable);
         }
     }
-    throw std::out_of_range(KEY_DOES_NOT_EXIST);
+    else
+    {
+        return false;
+    }
+    numOfPairs--;
+    while (table.capacity > minCapacity && getLoadFactor() < lowerLoadFactor)
+    {
+        _resize(table.capacity / 2);
+    }
+    return true;
 }
 
 /**
- * @brief Get value by key.
- * @param key to search by.
- * @return ValueT object if HashMap contains key, throws exception otherwise.
+ * @brief Erases the pair an iterator points to. Never rehashes, so the other iterators
+ * stay valid and a loop may go on erasing; the HashMap shrinks at a later erasure by key.
+ * @param pos iterator pointing to a pair of this HashMap.
+ * @return An iterator pointing to the pair after the erased one.
  */
-template<class KeyT, class ValueT>
-ValueT HashMap<KeyT, ValueT>::at(const KeyT &key) const
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+typename HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::iterator
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::erase(const_iterator pos)
 {
-    int place = _hash(key);
-    for (auto &i: vec[place])
+    iterator next(pos);
+    ++next;
+    if (pos.ictrl == table.ctrl)
+    {
+        if (table.clearSlot(pos.bucket))
+        {
+            tombstones++;
+        }
+        if (pos.bucket == firstFull)
+        {
+            _findFirstFull(pos.bucket + 1);
+        }
+    }
+    else
     {
-        if (i.first == key)
+        oldTable.clearSlot(pos.bucket);
+        // The next pair, if any, is in oldTable too, so oldTable stays while next needs it.
+        if (--oldCount == 0)
         {
-            return i.second;
+            _deallocate(oldTable);
         }
     }
-    throw std::out_of_range(KEY_DOES_NOT_EXIST);
+    numOfPairs--;
+    return next;
 }
 
 /**
- * @brief Erases key and value from HashMap.
- * @param key to erase.
- * @return true if erasure was successful, false otherwise.
+ * @brief Erases every pair a predicate holds for, going over the slots once, and shrinks
+ * the HashMap once at the end if it became too empty.
+ * @param pred called with a const reference to every pair.
+ * @return number of pairs erased.
  */
-template<class KeyT, class ValueT>
-bool HashMap<KeyT, ValueT>::erase(const KeyT &key)
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+template<class Predicate>
+typename HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::size_type
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::erase_if(Predicate pred)
 {
-    int index = _hash(key);
-    for (auto iter = vec[index].begin(); iter != vec[index].end(); iter++)
+    size_t erased = 0;
+    for (size_t i = firstFull; i < table.capacity; i++)
+    {
+        if (_isFull(table.ctrl[i]) && pred(static_cast<const pairType &>(table.slots[i])))
+        {
+            if (table.clearSlot(i))
+            {
+                tombstones++;
+            }
+            if (i == firstFull)
+            {
+                _findFirstFull(i + 1);
+            }
+            numOfPairs--;
+            erased++;
+        }
+    }
+    for (size_t i = 0; i < oldTable.capacity; i++)
     {
-        if (iter->first == key)
+        if (_isFull(oldTable.ctrl[i]) && pred(static_cast<const pairType &>(oldTable.slots[i])))
         {
-            vec[index].erase(iter);
-            count--;
-            while (capacity() > 1 && getLoadFactor() < LOWER_LOAD_FACTOR)
+            oldTable.clearSlot(i);
+            numOfPairs--;
+            erased++;
+            if (--oldCount == 0)
             {
-                _reHash(maxCapacity / 2);
+                _deallocate(oldTable);
             }
-            return true;
         }
     }
-    return false;
+    size_t newCapacity = table.capacity;
+    while (newCapacity > minCapacity && (double) numOfPairs / newCapacity < lowerLoadFactor)
+    {
+        newCapacity /= 2;
+    }
+    if (newCapacity < table.capacity)
+    {
+        _reHash(newCapacity);
+    }
+    return erased;
 }
 
 /**
  * @return gets current (double) load factor of the HashMap.
  */
-template<class KeyT, class ValueT>
-double HashMap<KeyT, ValueT>::getLoadFactor() const
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+double HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::getLoadFactor() const
 {
     return (double) size() / capacity();
 }
@@ -603,41 +2627,160 @@ double HashMap<KeyT, ValueT>::getLoadFactor() const
  * @param key to check size of bucket container.
  * @return number of items in bucket containing key.
  */
-template<class KeyT, class ValueT>
-int HashMap<KeyT, ValueT>::bucketSize(const KeyT &key) const
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+typename HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::size_type HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::bucketSize(const KeyT &key) const
 {
-    if (!containsKey(key))
+    size_t hash = _hash(key);
+    if (table.find(key, hash, keyEqual) != NO_SLOT)
     {
-        throw std::out_of_range(KEY_DOES_NOT_EXIST);
+        return table.countHome(table.home(hash));
+    }
+    if (_migrating() && oldTable.find(key, hash, keyEqual) != NO_SLOT)
+    {
+        return oldTable.countHome(oldTable.home(hash));
     }
-    return (int) vec[_hash(key)].size();
+    throw std::out_of_range(KEY_DOES_NOT_EXIST);
 }
 
 /**
  * @param key to search
  * @return index of bucket containing the key.
  */
-template<class KeyT, class ValueT>
-int HashMap<KeyT, ValueT>::bucketIndex(const KeyT &key) const
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+typename HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::size_type HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::bucketIndex(const KeyT &key) const
 {
-    if (!containsKey(key))
+    size_t hash = _hash(key);
+    if (table.find(key, hash, keyEqual) != NO_SLOT)
     {
-        throw std::out_of_range(KEY_DOES_NOT_EXIST);
+        return table.home(hash);
+    }
+    if (_migrating() && oldTable.find(key, hash, keyEqual) != NO_SLOT)
+    {
+        return oldTable.home(hash);
     }
-    return _hash(key);
+    throw std::out_of_range(KEY_DOES_NOT_EXIST);
 }
 
 /**
  * @brief clears all items from HashMap, doesn't update size.
  */
-template<class KeyT, class ValueT>
-void HashMap<KeyT, ValueT>::clear()
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::clear()
+{
+    _destroyAll(table);
+    if (_migrating())
+    {
+        _destroyAll(oldTable);
+        _deallocate(oldTable);
+    }
+    for (size_t i = 0; i < table.capacity + GROUP_WIDTH; ++i)
+    {
+        table.ctrl[i] = EMPTY_SLOT;
+    }
+    numOfPairs = 0;
+    tombstones = 0;
+    firstFull = table.capacity;
+    oldCount = 0;
+}
+
+/**
+ * @brief Exchanges the contents of this HashMap with other's.
+ * @param other HashMap to swap with.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::swap(HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &other)
+{
+    // Inline pairs can't change owners by swapping pointers, so both sides are moved.
+    HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> temp(hasher, keyEqual, allocator);
+    temp._moveFrom(*this);
+    _moveFrom(other);
+    other._moveFrom(temp);
+}
+
+/**
+ * @brief Grows the HashMap so it holds at least items pairs without rehashing, and keeps
+ * it from shrinking below that size by itself until shrink_to_fit() is called.
+ * @param items number of pairs to make room for.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::reserve(size_type items)
+{
+    size_t newCapacity = _fitCapacity(items);
+    if (newCapacity > minCapacity)
+    {
+        minCapacity = newCapacity;
+    }
+    if (newCapacity > table.capacity)
+    {
+        _reHash(newCapacity);
+    }
+}
+
+/**
+ * @brief Shrinks the HashMap to the smallest capacity holding its pairs, and forgets
+ * the size given to reserve().
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::shrink_to_fit()
+{
+    minCapacity = INLINE_CAPACITY;
+    size_t newCapacity = _fitCapacity(numOfPairs);
+    if (newCapacity < table.capacity)
+    {
+        _reHash(newCapacity);
+    }
+}
+
+/**
+ * @brief Sets the load factors the HashMap grows above and shrinks below. A shrink
+ * halves the load factor, so lower must be under half of upper for the HashMap not to
+ * grow right back, and growing must leave empty slots for probes to stop at.
+ * Throws std::invalid_argument unless 0 <= 2 * lower < upper < 1.
+ * @param upper load factor above which an insertion grows the HashMap.
+ * @param lower load factor below which an erasure shrinks the HashMap, 0 never shrinks.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::setLoadFactors(double upper, double lower)
+{
+    if (!(lower >= 0 && 2 * lower < upper && upper < 1))
+    {
+        throw std::invalid_argument(INVALID_LOAD_FACTORS);
+    }
+    upperLoadFactor = upper;
+    lowerLoadFactor = lower;
+}
+
+/**
+ * @brief Turns incremental rehashing on or off. When on, growing, shrinking and cleaning
+ * tombstones allocate the new table and leave the pairs where they are, the following
+ * insertions and erasures move them a few slots at a time, so no single insertion or
+ * erasure pays for moving all pairs. erase_if still shrinks at once.
+ * Turning it off finishes a running rehash.
+ * @param enable true to rehash incrementally.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::setIncrementalRehash(bool enable)
 {
-    for (int i = 0; i < maxCapacity; ++i)
+    incremental = enable;
+    if (!enable)
     {
-        vec[i].clear();
+        _migrate(oldTable.capacity);
     }
-    count = 0;
+}
+
+/**
+ * @brief Sets the most threads rehashing a HashMap uses. Each thread gets at least
+ * PARALLEL_PAIRS_PER_THREAD pairs, so small rehashes stay on fewer threads or on the
+ * calling thread, where starting threads would cost more than it saves. The pairs are
+ * split between the threads by their slot in the new table, so threads never write the
+ * same slots. Pairs whose move may throw are always moved by the calling thread.
+ * Incremental rehashes are not affected.
+ * @param threads number of threads, 0 and 1 rehash on the calling thread.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+void HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::setParallelRehash(unsigned int threads)
+{
+    rehashThreads = threads == 0 ? 1 : threads;
 }
 
 /**
@@ -645,21 +2788,67 @@ void HashMap<KeyT, ValueT>::clear()
  * Copies data from other HashMap to this HashMap.
  * @return Reference to current HashMap
  */
-template<class KeyT, class ValueT>
-HashMap<KeyT, ValueT> &HashMap<KeyT, ValueT>::operator=(const HashMap<KeyT, ValueT> &other)
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::operator=(const HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &other)
+{
+    if (&other == this)
+    {
+        return *this;
+    }
+    _release();
+    numOfPairs = 0;
+    tombstones = 0;
+    oldCount = 0;
+    incremental = other.incremental;
+    rehashThreads = other.rehashThreads;
+    upperLoadFactor = other.upperLoadFactor;
+    lowerLoadFactor = other.lowerLoadFactor;
+    minCapacity = other.minCapacity;
+    hasher = other.hasher;
+    keyEqual = other.keyEqual;
+    _copyFrom(other);
+    return *this;
+}
+
+/**
+ * @brief = operator overload when <HashMap_name>=<rvalue HashMap> is called,
+ * Takes other's pairs without copying them, along with its allocator. An allocator that
+ * doesn't propagate on move assignment and differs from other's can't free other's
+ * arrays, so then other's pairs are moved one by one into arrays of this allocator.
+ * Doesn't throw if the allocator propagates or all its instances are equal, unless
+ * moving a pair or copying the hash or equality object may throw.
+ * @return Reference to current HashMap
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::operator=(HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &&other)
+noexcept(nothrowMovable && (allocTraits::propagate_on_container_move_assignment::value ||
+                            allocTraits::is_always_equal::value))
 {
-    if (other == *this)
+    if (&other == this)
     {
         return *this;
     }
-    delete[] vec;
-    vec = new pairVector[other.capacity()];
-    for (int i = 0; i < other.capacity(); i++)
+    if (!allocTraits::propagate_on_container_move_assignment::value && !(allocator == other.allocator))
     {
-        vec[i] = other.vec[i];
+        clear();
+        incremental = other.incremental;
+        rehashThreads = other.rehashThreads;
+        upperLoadFactor = other.upperLoadFactor;
+        lowerLoadFactor = other.lowerLoadFactor;
+        minCapacity = other.minCapacity;
+        hasher = other.hasher;
+        keyEqual = other.keyEqual;
+        reserve(other.numOfPairs);
+        for (pairType &pair: other)
+        {
+            _tryEmplace(std::move(pair.first), std::move(pair.second));
+        }
+        other.clear();
+        return *this;
     }
-    maxCapacity = other.maxCapacity;
-    count = other.count;
+    _release();
+    table = _allocate(INLINE_CAPACITY);
+    _moveFrom(other);
     return *this;
 }
 
@@ -668,18 +2857,23 @@ HashMap<KeyT, ValueT> &HashMap<KeyT, ValueT>::operator=(const HashMap<KeyT, Valu
  * @return Reference to the ValueT item in the key place if it exists,
  * otherwise inserts default ValueT value and returns reference to it.
  */
-template<class KeyT, class ValueT>
-ValueT &HashMap<KeyT, ValueT>::operator[](const KeyT &key)
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+ValueT &HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::operator[](const KeyT &key)
 {
-    try
-    {
-        return at(key);
-    }
-    catch (std::out_of_range &e)
-    {
-        insert(key, ValueT());
-        return at(key);
-    }
+    size_t place = _tryEmplace(key).first;
+    return table.slots[place].second;
+}
+
+/**
+ * @brief [] operator overload when <HashMap_name>[KeyT key] is called with an rvalue key.
+ * @return Reference to the ValueT item in the key place if it exists,
+ * otherwise moves key in with a default ValueT value and returns reference to it.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+ValueT &HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::operator[](KeyT &&key)
+{
+    size_t place = _tryEmplace(std::move(key)).first;
+    return table.slots[place].second;
 }
 
 /**
@@ -687,17 +2881,11 @@ ValueT &HashMap<KeyT, ValueT>::operator[](const KeyT &key)
  * @return Reference to the ValueT item in the key place if it exists,
  * otherwise returns a reference to default ValueT.
  */
-template<class KeyT, class ValueT>
-ValueT HashMap<KeyT, ValueT>::operator[](const KeyT &key) const
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+ValueT HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::operator[](const KeyT &key) const
 {
-    try
-    {
-        return at(key);
-    }
-    catch (std::out_of_range &e)
-    {
-        return ValueT();
-    }
+    const_iterator place = find(key);
+    return place == end() ? ValueT() : place->second;
 }
 
 /**
@@ -705,8 +2893,8 @@ ValueT HashMap<KeyT, ValueT>::operator[](const KeyT &key) const
  * @return true if the group of keyT, ValueT pairs in current is
  * equal to the group of other HashMap, false otherwise.
  */
-template<class KeyT, class ValueT>
-bool HashMap<KeyT, ValueT>::operator==(const HashMap<KeyT, ValueT> &other) const
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+bool HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::operator==(const HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &other) const
 {
     if (size() != other.size())
     {
@@ -714,14 +2902,8 @@ bool HashMap<KeyT, ValueT>::operator==(const HashMap<KeyT, ValueT> &other) const
     }
     for (auto &pair: other)
     {
-        if (containsKey(pair.first))
-        {
-            if (at(pair.first) != pair.second)
-            {
-                return false;
-            }
-        }
-        else
+        const_iterator place = find(pair.first);
+        if (place == end() || place->second != pair.second)
         {
             return false;
         }
@@ -734,8 +2916,8 @@ bool HashMap<KeyT, ValueT>::operator==(const HashMap<KeyT, ValueT> &other) const
  * @return true if the group of keyT, ValueT pairs in current is
  * unequal to the group of other HashMap, false otherwise.
  */
-template<class KeyT, class ValueT>
-bool HashMap<KeyT, ValueT>::operator!=(const HashMap<KeyT, ValueT> &other) const
+template<class KeyT, class ValueT, class Hash, class KeyEqual, class Alloc>
+bool HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc>::operator!=(const HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &other) const
 {
     return !(other == *this);
 }
@@ -0,0 +1,61 @@
+#include <cstddef>
+#include <string>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#ifndef CPP_EX3_LOWERCASE_HPP
+#define CPP_EX3_LOWERCASE_HPP
+
+/**
+ * @brief Turns all letter in a buffer to lowercase, in place, as tolower does in the "C"
+ * locale the program runs in: only A to Z change. Goes over 32 or 16 chars at a time
+ * with AVX2 or SSE2.
+ * @param str the buffer to change.
+ * @param length number of chars in the buffer.
+ */
+inline void toLowerCase(char *str, size_t length)
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 32 <= length; i += 32)
+    {
+        __m256i bytes = _mm256_loadu_si256((const __m256i *) (str + i));
+        __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8('A' - 1)),
+                                         _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), bytes));
+        bytes = _mm256_or_si256(bytes, _mm256_and_si256(upper, _mm256_set1_epi8('a' - 'A')));
+        _mm256_storeu_si256((__m256i *) (str + i), bytes);
+    }
+#elif defined(__SSE2__)
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i bytes = _mm_loadu_si128((const __m128i *) (str + i));
+        __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('A' - 1)),
+                                      _mm_cmplt_epi8(bytes, _mm_set1_epi8('Z' + 1)));
+        bytes = _mm_or_si128(bytes, _mm_and_si128(upper, _mm_set1_epi8('a' - 'A')));
+        _mm_storeu_si128((__m128i *) (str + i), bytes);
+    }
+#endif
+    for (; i < length; i++)
+    {
+        if (str[i] >= 'A' && str[i] <= 'Z')
+        {
+            str[i] = (char) (str[i] - 'A' + 'a');
+        }
+    }
+}
+
+/**
+ * @brief Turns all letter in a string to lowercase, in place.
+ * @param str the string to change.
+ */
+inline void toLowerCase(std::string &str)
+{
+    toLowerCase(&str[0], str.size());
+}
+
+
+#endif //CPP_EX3_LOWERCASE_HPP
@@ -0,0 +1,703 @@
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "FrozenHashMap.hpp"
+
+#ifndef CPP_EX3_MAPPEDHASHMAP_HPP
+#define CPP_EX3_MAPPEDHASHMAP_HPP
+
+#define IMAGE_MAGIC 0x50414D4853414846ULL
+
+#define IMAGE_VERSION 2
+
+#define IMAGE_BYTE_ORDER 0x0102030405060708ULL
+
+#define IMAGE_STRING_KEY 0
+
+#define CANT_OPEN_IMAGE "Can't open the image file"
+
+#define CANT_WRITE_IMAGE "Can't write the image file"
+
+#define NOT_AN_IMAGE "The file isn't a HashMap image of these key and value types"
+
+#define WRONG_IMAGE_VERSION "The image was written by another version of the format"
+
+#define CORRUPT_IMAGE "The image's checksum doesn't match its content"
+
+/**
+ * @brief How the keys of an image are stored. Trivially copyable keys are stored as they are
+ * and looked up as const references.
+ * @tparam KeyT type of keys.
+ */
+template<class KeyT, class Enable = void>
+struct ImageKey
+{
+    static_assert(std::is_trivially_copyable<KeyT>::value,
+                  "Image keys must be std::string or trivially copyable");
+
+    typedef KeyT stored;
+
+    typedef const KeyT &view;
+
+    /**
+     * @brief Size recorded in the header, so an image isn't opened with another key type.
+     */
+    static constexpr uint64_t size = sizeof(KeyT);
+
+    /**
+     * @param key key to store.
+     * @param bytes variable length area of the image, unused.
+     * @return the stored form of key.
+     */
+    static stored encode(const KeyT &key, std::string &bytes)
+    {
+        (void) bytes;
+        return key;
+    }
+
+    /**
+     * @param key stored key.
+     * @param bytes start of the variable length area, unused.
+     * @return the key to compare and hash.
+     */
+    static view decode(const stored &key, const char *bytes)
+    {
+        (void) bytes;
+        return key;
+    }
+
+    /**
+     * @param key stored key.
+     * @param numOfBytes length of the variable length area, unused.
+     * @return true, the key is read from its slot only.
+     */
+    static bool fits(const stored &key, uint64_t numOfBytes)
+    {
+        (void) key;
+        (void) numOfBytes;
+        return true;
+    }
+};
+
+/**
+ * @brief std::string keys are stored as an offset and a length into the variable length
+ * area of the image and looked up as std::string_view, without a copy.
+ */
+template<>
+struct ImageKey<std::string>
+{
+    struct stored
+    {
+        uint64_t offset;
+        uint64_t length;
+    };
+
+    typedef std::string_view view;
+
+    static constexpr uint64_t size = IMAGE_STRING_KEY;
+
+    /**
+     * @param key key to store.
+     * @param bytes variable length area of the image, the characters are appended to it.
+     * @return the stored form of key.
+     */
+    static stored encode(const std::string &key, std::string &bytes)
+    {
+        stored record{bytes.size(), key.size()};
+        bytes += key;
+        return record;
+    }
+
+    /**
+     * @param key stored key.
+     * @param bytes start of the variable length area.
+     * @return view of the key's characters in the image.
+     */
+    static view decode(const stored &key, const char *bytes)
+    {
+        return view(bytes + key.offset, key.length);
+    }
+
+    /**
+     * @param key stored key.
+     * @param numOfBytes length of the variable length area.
+     * @return true if the key's characters lie inside the variable length area.
+     */
+    static bool fits(const stored &key, uint64_t numOfBytes)
+    {
+        return key.offset <= numOfBytes && key.length <= numOfBytes - key.offset;
+    }
+};
+
+/**
+ * @brief Read only map over a binary image file, mapped into memory instead of parsed.
+ * The image holds the minimal perfect hash of a FrozenHashMap: a header, the pilots, the
+ * slots of the positions past the last slot, one slot per pair and the characters of the keys. Every reference inside it is an offset from
+ * its start, so it is used in place from any address, and processes mapping the same file
+ * share its pages through the page cache. Opening an image costs a few system calls, one
+ * pass checking the remapped positions and std::string keys point inside the image, and,
+ * unless skipped, one computing its checksum.
+ * Values must be trivially copyable, keys std::string or trivially copyable. Hash must give
+ * the same results in every process, as IntegerHash and StringHash do, and the header only
+ * catches a different format or byte order, not a different Hash.
+ * @tparam KeyT Objects to search ValueT by.
+ * @tparam ValueT Object to hold.
+ * @tparam Hash hash of KeyT objects, the one the image was saved with.
+ * @tparam KeyEqual equality of KeyT objects, must also compare keys to std::string_view when
+ * KeyT is std::string.
+ */
+template<class KeyT, class ValueT, class Hash = DefaultHash<KeyT>, class KeyEqual = DefaultEqual<KeyT>>
+class MappedHashMap
+{
+    static_assert(std::is_trivially_copyable<ValueT>::value, "Image values must be trivially copyable");
+
+private:
+    typedef ImageKey<KeyT> keyFormat;
+
+    typedef typename keyFormat::view keyView;
+
+    typedef FrozenHashMap<KeyT, ValueT, Hash, KeyEqual> frozenType;
+
+    /**
+     * @brief Start of the image, all of its fields are 64 bits wide.
+     */
+    struct Header
+    {
+        uint64_t magic;
+        uint64_t version;
+        uint64_t byteOrder;
+        uint64_t keySize;
+        uint64_t valueSize;
+        uint64_t numOfPairs;
+        uint64_t numOfBuckets;
+        uint64_t numOfRemapped;
+        uint64_t pilotsOffset;
+        uint64_t remapOffset;
+        uint64_t slotsOffset;
+        uint64_t bytesOffset;
+        uint64_t fileSize;
+        uint64_t checksum;
+    };
+
+    /**
+     * @brief A pair as stored in the image.
+     */
+    struct Slot
+    {
+        typename keyFormat::stored key;
+        ValueT value;
+    };
+
+    /**
+     * @brief Start of the mapping.
+     */
+    const char *image;
+
+    /**
+     * @brief Length of the mapping.
+     */
+    size_t imageSize;
+
+    /**
+     * @brief Header of the image.
+     */
+    const Header *header;
+
+    /**
+     * @brief Pilot of every bucket, inside the image.
+     */
+    const uint32_t *pilots;
+
+    /**
+     * @brief Slot of every position past the last slot, inside the image.
+     */
+    const uint64_t *remap;
+
+    /**
+     * @brief One slot per pair, inside the image.
+     */
+    const Slot *slots;
+
+    /**
+     * @brief Characters of the keys, inside the image.
+     */
+    const char *bytes;
+
+    /**
+     * @brief Hash of keys.
+     */
+    Hash hasher;
+
+    /**
+     * @brief Equality of keys.
+     */
+    KeyEqual keyEqual;
+
+    /**
+     * @brief Enables the lookups taking other types than KeyT, only when both Hash and
+     * KeyEqual declare is_transparent.
+     */
+    template<class K>
+    using _transparent = typename std::enable_if<IsTransparent<Hash>::value && IsTransparent<KeyEqual>::value,
+            K>::type;
+
+    /**
+     * @param offset offset in the image.
+     * @return offset rounded up to the alignment of the remap section.
+     */
+    static uint64_t _alignRemap(uint64_t offset)
+    {
+        return (offset + alignof(uint64_t) - 1) / alignof(uint64_t) * alignof(uint64_t);
+    }
+
+    /**
+     * @param offset offset in the image.
+     * @return offset rounded up to the alignment of a slot.
+     */
+    static uint64_t _alignSlots(uint64_t offset)
+    {
+        return (offset + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+    }
+
+    /**
+     * @param data first byte after the header.
+     * @param length number of bytes after the header.
+     * @return checksum of the bytes.
+     */
+    static uint64_t _checksum(const char *data, size_t length)
+    {
+        return StringHash::hashBytes(data, length, IMAGE_VERSION);
+    }
+
+    /**
+     * @brief Checks the header and locates the sections, unmaps the image and throws if it
+     * can't be used.
+     * @param verify true to compare the checksum to the content.
+     */
+    void _open(bool verify);
+
+    /**
+     * @brief Writes an image to a new file next to path, syncs it and renames it over path,
+     * so processes that mapped the old file keep reading it intact, then syncs the directory.
+     * @param head header of the image.
+     * @param body sections following the header.
+     * @param path file to replace.
+     */
+    static void _writeFile(const Header &head, const std::vector<char> &body, const std::string &path);
+
+    /**
+     * @brief Looks for a key with a single probe, as FrozenHashMap does.
+     * @param key KeyT object, or object KeyEqual compares to keys if lookups are transparent.
+     * @return index of the slot holding key, NO_SLOT if key isn't in the map.
+     */
+    template<class K>
+    size_t _locate(const K &key) const
+    {
+        if (header->numOfPairs == 0)
+        {
+            return NO_SLOT;
+        }
+        size_t hash = hasher(key);
+        hash = IsAvalanching<Hash>::value ? hash : IntegerHash()(hash);
+        size_t place = frozenType::_slot(hash, pilots, (size_t) header->numOfBuckets, remap,
+                                         (size_t) header->numOfRemapped, (size_t) header->numOfPairs);
+        return keyEqual(key, keyFormat::decode(slots[place].key, bytes)) ? place : NO_SLOT;
+    }
+
+public:
+    typedef size_t size_type;
+
+    /**
+     * @brief Maps an image file read only.
+     * @param path image file, written by save.
+     * @param verify false to skip computing the checksum, for images known to be intact.
+     */
+    explicit MappedHashMap(const std::string &path, bool verify = true);
+
+    MappedHashMap(const MappedHashMap &other) = delete;
+
+    MappedHashMap &operator=(const MappedHashMap &other) = delete;
+
+    /**
+     * @brief MappedHashMap destructor, unmaps the image.
+     */
+    ~MappedHashMap()
+    {
+        munmap(const_cast<char *>(image), imageSize);
+    }
+
+    /**
+     * @brief Writes the image of a FrozenHashMap.
+     * @param map map to write, with the same Hash the image will be opened with.
+     * @param path file to write, replaced if it exists.
+     */
+    static void save(const frozenType &map, const std::string &path);
+
+    /**
+     * @brief Writes the image of a HashMap, freezing it first.
+     * @param map map to write.
+     * @param path file to write, replaced if it exists.
+     */
+    template<class Alloc>
+    static void save(const HashMap<KeyT, ValueT, Hash, KeyEqual, Alloc> &map, const std::string &path)
+    {
+        save(frozenType(map), path);
+    }
+
+    /**
+     * @return number of items in the map.
+     */
+    size_type size() const
+    {
+        return (size_type) header->numOfPairs;
+    }
+
+    /**
+     * @return true if the map is empty.
+     */
+    bool empty() const
+    {
+        return header->numOfPairs == 0;
+    }
+
+    /**
+     * @brief checks if a given key is contained in the map.
+     * @param key the key to search for.
+     * @return true if the map contains the key, false otherwise.
+     */
+    bool containsKey(const KeyT &key) const
+    {
+        return _locate(key) != NO_SLOT;
+    }
+
+    /**
+     * @brief checks if a key given as another type is contained in the map, only when
+     * lookups are transparent.
+     * @param key object Hash accepts and KeyEqual compares to keys.
+     * @return true if the map contains the key, false otherwise.
+     */
+    template<class K, class = _transparent<K>>
+    bool containsKey(const K &key) const
+    {
+        return _locate(key) != NO_SLOT;
+    }
+
+    /**
+     * @brief Get value by key.
+     * @param key to search by.
+     * @return reference to the value in the image if the map contains key, throws exception
+     * otherwise.
+     */
+    const ValueT &at(const KeyT &key) const;
+
+    /**
+     * @brief Get value by a key given as another type, only when lookups are transparent.
+     * @param key object Hash accepts and KeyEqual compares to keys.
+     * @return reference to the value in the image if the map contains key, throws exception
+     * otherwise.
+     */
+    template<class K, class = _transparent<K>>
+    const ValueT &at(const K &key) const
+    {
+        size_t place = _locate(key);
+        if (place == NO_SLOT)
+        {
+            throw std::out_of_range(KEY_DOES_NOT_EXIST);
+        }
+        return slots[place].value;
+    }
+
+    /**
+     * @brief Get value by key without throwing.
+     * @param key to search by.
+     * @param val set to a copy of the value if the map contains key.
+     * @return true if the map contains key, false otherwise.
+     */
+    bool find(const KeyT &key, ValueT &val) const
+    {
+        size_t place = _locate(key);
+        if (place == NO_SLOT)
+        {
+            return false;
+        }
+        val = slots[place].value;
+        return true;
+    }
+
+    /**
+     * @brief Calls visit on every pair, in slot order.
+     * @param visit called with the key, as a std::string_view for std::string keys, and a
+     * const reference to the value.
+     */
+    template<class Function>
+    void forEach(Function visit) const
+    {
+        for (size_t i = 0; i < header->numOfPairs; i++)
+        {
+            visit(keyFormat::decode(slots[i].key, bytes), slots[i].value);
+        }
+    }
+
+    /**
+     * @brief Copies the image into a mutable HashMap.
+     * @return HashMap holding every pair of the image.
+     */
+    HashMap<KeyT, ValueT, Hash, KeyEqual> toHashMap() const;
+};
+
+/**
+ * @brief Maps an image file read only.
+ * @param path image file, written by save.
+ * @param verify false to skip computing the checksum, for images known to be intact.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+MappedHashMap<KeyT, ValueT, Hash, KeyEqual>::MappedHashMap(const std::string &path, bool verify) :
+        image(nullptr), imageSize(0), header(nullptr), pilots(nullptr), remap(nullptr), slots(nullptr), bytes(nullptr)
+{
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        throw std::runtime_error(CANT_OPEN_IMAGE);
+    }
+    struct stat status{};
+    if (fstat(file, &status) != 0 || (size_t) status.st_size < sizeof(Header))
+    {
+        ::close(file);
+        throw std::invalid_argument(NOT_AN_IMAGE);
+    }
+    imageSize = (size_t) status.st_size;
+    void *mapping = mmap(nullptr, imageSize, PROT_READ, MAP_SHARED, file, 0);
+    ::close(file);
+    if (mapping == MAP_FAILED)
+    {
+        throw std::runtime_error(CANT_OPEN_IMAGE);
+    }
+    image = static_cast<const char *>(mapping);
+    _open(verify);
+}
+
+/**
+ * @brief Checks the header and locates the sections, unmaps the image and throws if it
+ * can't be used.
+ * @param verify true to compare the checksum to the content.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+void MappedHashMap<KeyT, ValueT, Hash, KeyEqual>::_open(bool verify)
+{
+    header = reinterpret_cast<const Header *>(image);
+    const char *error = nullptr;
+    if (header->magic != IMAGE_MAGIC || header->byteOrder != IMAGE_BYTE_ORDER ||
+        header->keySize != keyFormat::size || header->valueSize != sizeof(ValueT))
+    {
+        error = NOT_AN_IMAGE;
+    }
+    else if (header->version != IMAGE_VERSION)
+    {
+        error = WRONG_IMAGE_VERSION;
+    }
+    else if (header->fileSize != imageSize || header->pilotsOffset != sizeof(Header) ||
+             header->numOfBuckets > (imageSize - header->pilotsOffset) / sizeof(uint32_t) ||
+             header->remapOffset != _alignRemap(header->pilotsOffset + header->numOfBuckets * sizeof(uint32_t)) ||
+             header->remapOffset > imageSize ||
+             header->numOfRemapped > (imageSize - header->remapOffset) / sizeof(uint64_t) ||
+             header->slotsOffset != _alignSlots(header->remapOffset + header->numOfRemapped * sizeof(uint64_t)) ||
+             header->slotsOffset > imageSize ||
+             header->numOfPairs > (imageSize - header->slotsOffset) / sizeof(Slot) ||
+             header->bytesOffset != header->slotsOffset + header->numOfPairs * sizeof(Slot) ||
+             (header->numOfPairs != 0 && header->numOfBuckets == 0))
+    {
+        error = CORRUPT_IMAGE;
+    }
+    else if (verify && _checksum(image + sizeof(Header), imageSize - sizeof(Header)) != header->checksum)
+    {
+        error = CORRUPT_IMAGE;
+    }
+    else
+    {
+        // Lookups index the slots with the remapped positions, and read keys at their
+        // offsets, without checking either, so an image opened without its checksum must
+        // not point outside itself.
+        const uint64_t *slotOf = reinterpret_cast<const uint64_t *>(image + header->remapOffset);
+        const Slot *stored = reinterpret_cast<const Slot *>(image + header->slotsOffset);
+        uint64_t numOfBytes = imageSize - header->bytesOffset;
+        for (size_t i = 0; i < std::max(header->numOfRemapped, header->numOfPairs) && error == nullptr; i++)
+        {
+            if ((i < header->numOfRemapped && slotOf[i] >= header->numOfPairs) ||
+                (i < header->numOfPairs && !keyFormat::fits(stored[i].key, numOfBytes)))
+            {
+                error = CORRUPT_IMAGE;
+            }
+        }
+    }
+    if (error != nullptr)
+    {
+        munmap(const_cast<char *>(image), imageSize);
+        throw std::invalid_argument(error);
+    }
+    pilots = reinterpret_cast<const uint32_t *>(image + header->pilotsOffset);
+    remap = reinterpret_cast<const uint64_t *>(image + header->remapOffset);
+    slots = reinterpret_cast<const Slot *>(image + header->slotsOffset);
+    bytes = image + header->bytesOffset;
+}
+
+/**
+ * @brief Writes the image of a FrozenHashMap.
+ * @param map map to write, with the same Hash the image will be opened with.
+ * @param path file to write, replaced if it exists.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+void MappedHashMap<KeyT, ValueT, Hash, KeyEqual>::save(const frozenType &map, const std::string &path)
+{
+    Header head{};
+    head.magic = IMAGE_MAGIC;
+    head.version = IMAGE_VERSION;
+    head.byteOrder = IMAGE_BYTE_ORDER;
+    head.keySize = keyFormat::size;
+    head.valueSize = sizeof(ValueT);
+    head.numOfPairs = map.slots.size();
+    head.numOfBuckets = map.pilots.size();
+    head.numOfRemapped = map.remap.size();
+    head.pilotsOffset = sizeof(Header);
+    head.remapOffset = _alignRemap(head.pilotsOffset + head.numOfBuckets * sizeof(uint32_t));
+    head.slotsOffset = _alignSlots(head.remapOffset + head.numOfRemapped * sizeof(uint64_t));
+    head.bytesOffset = head.slotsOffset + head.numOfPairs * sizeof(Slot);
+    // The sections are laid out in one buffer, so the checksum is taken before writing.
+    std::string keyBytes;
+    std::vector<char> body(head.bytesOffset - sizeof(Header), 0);
+    if (!map.pilots.empty())
+    {
+        std::memcpy(body.data(), map.pilots.data(), map.pilots.size() * sizeof(uint32_t));
+    }
+    for (size_t i = 0; i < map.remap.size(); i++)
+    {
+        uint64_t slot = map.remap[i];
+        std::memcpy(body.data() + head.remapOffset - sizeof(Header) + i * sizeof(uint64_t), &slot, sizeof(uint64_t));
+    }
+    for (size_t i = 0; i < map.slots.size(); i++)
+    {
+        Slot slot;
+        std::memset(&slot, 0, sizeof(Slot));
+        slot.key = keyFormat::encode(map.slots[i].first, keyBytes);
+        slot.value = map.slots[i].second;
+        std::memcpy(body.data() + head.slotsOffset - sizeof(Header) + i * sizeof(Slot), &slot, sizeof(Slot));
+    }
+    body.insert(body.end(), keyBytes.begin(), keyBytes.end());
+    head.fileSize = sizeof(Header) + body.size();
+    head.checksum = _checksum(body.data(), body.size());
+    _writeFile(head, body, path);
+}
+
+/**
+ * @brief Writes an image to a new file next to path, syncs it and renames it over path,
+ * so processes that mapped the old file keep reading it intact, then syncs the directory.
+ * Truncating the old file in place would cut the pages under their mappings, and reading
+ * them would then raise SIGBUS.
+ * @param head header of the image.
+ * @param body sections following the header.
+ * @param path file to replace.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+void MappedHashMap<KeyT, ValueT, Hash, KeyEqual>::_writeFile(const Header &head, const std::vector<char> &body,
+                                                             const std::string &path)
+{
+    // Threads saving to the same path, in this process or another, each write their own file.
+    static std::atomic<uint64_t> saves(0);
+    std::string temporary = path + ".tmp." + std::to_string(getpid()) + "." +
+                            std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + "." +
+                            std::to_string(saves++);
+    int file = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (file < 0)
+    {
+        throw std::runtime_error(CANT_WRITE_IMAGE);
+    }
+    const char *parts[] = {reinterpret_cast<const char *>(&head), body.data()};
+    size_t lengths[] = {sizeof(Header), body.size()};
+    bool written = true;
+    for (int part = 0; part < 2 && written; part++)
+    {
+        size_t done = 0;
+        while (done < lengths[part])
+        {
+            ssize_t count = ::write(file, parts[part] + done, lengths[part] - done);
+            if (count < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (count <= 0)
+            {
+                written = false;
+                break;
+            }
+            done += (size_t) count;
+        }
+    }
+    written = fsync(file) == 0 && written;
+    written = ::close(file) == 0 && written;
+    if (!written || std::rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        ::unlink(temporary.c_str());
+        throw std::runtime_error(CANT_WRITE_IMAGE);
+    }
+    // The rename is durable only once the directory holding path is synced too.
+    size_t slash = path.rfind('/');
+    std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    int parent = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    bool synced = parent >= 0 && fsync(parent) == 0;
+    if (parent >= 0)
+    {
+        ::close(parent);
+    }
+    if (!synced)
+    {
+        throw std::runtime_error(CANT_WRITE_IMAGE);
+    }
+}
+
+/**
+ * @brief Get value by key.
+ * @param key to search by.
+ * @return reference to the value in the image if the map contains key, throws exception
+ * otherwise.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+const ValueT &MappedHashMap<KeyT, ValueT, Hash, KeyEqual>::at(const KeyT &key) const
+{
+    size_t place = _locate(key);
+    if (place == NO_SLOT)
+    {
+        throw std::out_of_range(KEY_DOES_NOT_EXIST);
+    }
+    return slots[place].value;
+}
+
+/**
+ * @brief Copies the image into a mutable HashMap.
+ * @return HashMap holding every pair of the image.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+HashMap<KeyT, ValueT, Hash, KeyEqual> MappedHashMap<KeyT, ValueT, Hash, KeyEqual>::toHashMap() const
+{
+    HashMap<KeyT, ValueT, Hash, KeyEqual> map(hasher, keyEqual);
+    map.reserve(size());
+    forEach([&map](keyView key, const ValueT &value)
+            { map.insert(KeyT(key), value); });
+    return map;
+}
+
+
+#endif //CPP_EX3_MAPPEDHASHMAP_HPP
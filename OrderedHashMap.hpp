@@ -0,0 +1,686 @@
+#include <vector>
+#include <utility>
+#include <tuple>
+#include <stdexcept>
+#include <initializer_list>
+#include <cstdint>
+#include "HashMap.hpp"
+
+#ifndef CPP_EX3_ORDEREDHASHMAP_HPP
+#define CPP_EX3_ORDEREDHASHMAP_HPP
+
+#define ORDERED_MIN_CAPACITY 8
+
+#define NO_ENTRY UINT32_MAX
+
+#define TOO_MANY_PAIRS "An OrderedHashMap holds less than 2^32 - 1 pairs"
+
+/**
+ * @brief Map keeping its pairs in insertion order in one contiguous array, with a separate
+ * small index table to find them (as in Python's compact dict). The index is an open
+ * addressing table of 8 byte slots, each holding the position of a pair in the array and
+ * 32 bits of its hash, probed linearly and kept at most half full. Iterating goes straight
+ * over the array, which holds no empty slots, and always gives the pairs in the order they
+ * were inserted.
+ * Erasing keeps the order and moves the later pairs, unordered_erase moves the last pair
+ * into the hole instead.
+ * @tparam KeyT Objects to search ValueT by.
+ * @tparam ValueT Object to hold.
+ * @tparam Hash hash of KeyT objects, its result is mixed first unless it is avalanching.
+ * @tparam KeyEqual equality of KeyT objects, lookups are transparent as in HashMap.
+ */
+template<class KeyT, class ValueT, class Hash = DefaultHash<KeyT>, class KeyEqual = DefaultEqual<KeyT>>
+class OrderedHashMap
+{
+private:
+    typedef std::pair<KeyT, ValueT> pairType;
+
+    /**
+     * @brief Slot of the index table.
+     */
+    struct IndexSlot
+    {
+        /**
+         * @brief position of the pair in entries, NO_ENTRY if the slot is empty.
+         */
+        uint32_t entry;
+
+        /**
+         * @brief hash of the pair's key folded to 32 bits, its low bits pick the home slot.
+         */
+        uint32_t hash;
+    };
+
+    /**
+     * @brief Pairs in insertion order.
+     */
+    std::vector<pairType> entries;
+
+    /**
+     * @brief Index table, empty or of a power of two size.
+     */
+    std::vector<IndexSlot> index;
+
+    /**
+     * @brief Hash of keys.
+     */
+    Hash hasher;
+
+    /**
+     * @brief Equality of keys.
+     */
+    KeyEqual keyEqual;
+
+    /**
+     * @brief Enables the lookups taking other types than KeyT, only when both Hash and
+     * KeyEqual declare is_transparent.
+     */
+    template<class K>
+    using _transparent = typename std::enable_if<IsTransparent<Hash>::value && IsTransparent<KeyEqual>::value,
+            K>::type;
+
+    /**
+     * @param key KeyT object, or object Hash accepts if lookups are transparent, to hash.
+     * @return hash of key, mixed the same way HashMap mixes it and folded to 32 bits.
+     */
+    template<class K>
+    uint32_t _hash(const K &key) const
+    {
+        uint64_t hash = hasher(key);
+        hash = IsAvalanching<Hash>::value ? hash : IntegerHash()(hash);
+        return (uint32_t) (hash ^ (hash >> 32));
+    }
+
+    /**
+     * @brief Looks for a key in the index, which must not be empty.
+     * @param key KeyT object, or object KeyEqual compares to keys if lookups are transparent.
+     * @param hash hash of key, as _hash returns it.
+     * @return index slot referring to key, or else the empty slot ending its probe.
+     */
+    template<class K>
+    size_t _probe(const K &key, uint32_t hash) const
+    {
+        size_t mask = index.size() - 1;
+        size_t place = hash & mask;
+        while (index[place].entry != NO_ENTRY &&
+               !(index[place].hash == hash && keyEqual(entries[index[place].entry].first, key)))
+        {
+            place = (place + 1) & mask;
+        }
+        return place;
+    }
+
+    /**
+     * @brief Looks for a key.
+     * @param key KeyT object, or object KeyEqual compares to keys if lookups are transparent.
+     * @return position of key's pair in entries, NO_SLOT if key isn't in the map.
+     */
+    template<class K>
+    size_t _locate(const K &key) const
+    {
+        if (entries.empty())
+        {
+            return NO_SLOT;
+        }
+        uint32_t entry = index[_probe(key, _hash(key))].entry;
+        return entry == NO_ENTRY ? NO_SLOT : entry;
+    }
+
+    /**
+     * @brief Appends a pair unless its key is already in the map.
+     * @param key key of the pair.
+     * @param args arguments to construct ValueT from.
+     * @return position of key's pair in entries, and true if it was appended.
+     */
+    template<class K, class... Args>
+    std::pair<size_t, bool> _tryEmplace(K &&key, Args &&... args);
+
+    /**
+     * @brief Empties an index slot, moving later slots of the same run back so that
+     * probes need no tombstones.
+     * @param hole index slot to empty.
+     */
+    void _removeSlot(size_t hole);
+
+    /**
+     * @brief Builds a new index table from the folded hashes kept in the old one, without
+     * hashing any key.
+     * @param newCapacity size of the new table, a power of two above twice the size.
+     */
+    void _reIndex(size_t newCapacity);
+
+public:
+    typedef size_t size_type;
+
+    typedef typename std::vector<pairType>::const_iterator const_iterator;
+
+    /**
+     * @brief OrderedHashMap constructor, allocates nothing until the first insertion.
+     * @param hash hash of keys.
+     * @param equal equality of keys.
+     */
+    explicit OrderedHashMap(const Hash &hash = Hash(), const KeyEqual &equal = KeyEqual()) :
+            hasher(hash), keyEqual(equal)
+    {
+    }
+
+    /**
+     * @brief Constructor that receives values in two separate vectors, a later pair of a
+     * repeated key replaces the value of the earlier one and keeps its place.
+     * @param keys const reference to KeyT object vector.
+     * @param values const reference to ValueT object vector.
+     */
+    OrderedHashMap(const std::vector<KeyT> &keys, const std::vector<ValueT> &values);
+
+    /**
+     * @brief Builds an OrderedHashMap from a list of pairs, a later pair of a repeated key
+     * replaces the value of the earlier one and keeps its place.
+     * @param list pairs to hold.
+     */
+    OrderedHashMap(std::initializer_list<pairType> list);
+
+    /**
+     * @return number of items in the map.
+     */
+    size_type size() const
+    {
+        return entries.size();
+    }
+
+    /**
+     * @return number of slots of the index table.
+     */
+    size_type capacity() const
+    {
+        return index.size();
+    }
+
+    /**
+     * @return true if the map is empty.
+     */
+    bool empty() const
+    {
+        return entries.empty();
+    }
+
+    /**
+     * @brief inserts a new value after all the others.
+     * @param key to locate value by.
+     * @param val value to input.
+     * @return true if insertion was successful, false if key was already in the map.
+     */
+    bool insert(const KeyT &key, const ValueT &val)
+    {
+        return _tryEmplace(key, val).second;
+    }
+
+    /**
+     * @brief inserts a new value after all the others, moving key and value in.
+     * @param key to locate value by.
+     * @param val value to input.
+     * @return true if insertion was successful, false if key was already in the map.
+     */
+    bool insert(KeyT &&key, ValueT &&val)
+    {
+        return _tryEmplace(std::move(key), std::move(val)).second;
+    }
+
+    /**
+     * @brief checks if a given key is contained in the map.
+     * @param key the key to search for.
+     * @return true if the map contains the key, false otherwise.
+     */
+    bool containsKey(const KeyT &key) const
+    {
+        return _locate(key) != NO_SLOT;
+    }
+
+    /**
+     * @brief checks if a key given as another type is contained in the map, only when
+     * lookups are transparent.
+     * @param key object Hash accepts and KeyEqual compares to keys.
+     * @return true if the map contains the key, false otherwise.
+     */
+    template<class K, class = _transparent<K>>
+    bool containsKey(const K &key) const
+    {
+        return _locate(key) != NO_SLOT;
+    }
+
+    /**
+     * @brief Counts the pairs of a key.
+     * @param key the key to search for.
+     * @return 1 if the map contains the key, 0 otherwise.
+     */
+    size_type count(const KeyT &key) const
+    {
+        return _locate(key) != NO_SLOT ? 1 : 0;
+    }
+
+    /**
+     * @brief Get value by key.
+     * @param key to search by.
+     * @return reference to ValueT object if the map contains key, throws exception otherwise.
+     */
+    ValueT &at(const KeyT &key);
+
+    /**
+     * @brief Get value by key.
+     * @param key to search by.
+     * @return reference to ValueT object if the map contains key, throws exception otherwise.
+     */
+    const ValueT &at(const KeyT &key) const;
+
+    /**
+     * @brief Get value by a key given as another type, only when lookups are transparent.
+     * @param key object Hash accepts and KeyEqual compares to keys.
+     * @return reference to ValueT object if the map contains key, throws exception otherwise.
+     */
+    template<class K, class = _transparent<K>>
+    const ValueT &at(const K &key) const
+    {
+        size_t place = _locate(key);
+        if (place == NO_SLOT)
+        {
+            throw std::out_of_range(KEY_DOES_NOT_EXIST);
+        }
+        return entries[place].second;
+    }
+
+    /**
+     * @brief Erases key and value, moving the later pairs one place back to keep the
+     * order, which takes time linear in the size.
+     * @param key to erase.
+     * @return true if erasure was successful, false otherwise.
+     */
+    bool erase(const KeyT &key);
+
+    /**
+     * @brief Erases key and value in constant time, moving the last pair into their place.
+     * @param key to erase.
+     * @return true if erasure was successful, false otherwise.
+     */
+    bool unordered_erase(const KeyT &key);
+
+    /**
+     * @brief Erases all of the items, keeping the allocated memory.
+     */
+    void clear();
+
+    /**
+     * @brief Makes room for a number of items, so that inserting them allocates nothing.
+     * @param items number of items the map should hold.
+     */
+    void reserve(size_type items);
+
+    /**
+     * @brief Looks for a key without throwing.
+     * @param key to search for.
+     * @return A const iterator pointing to key's pair, end() if key isn't in the map.
+     */
+    const_iterator find(const KeyT &key) const
+    {
+        size_t place = _locate(key);
+        return place == NO_SLOT ? end() : entries.begin() + place;
+    }
+
+    /**
+     * @brief Looks for a key given as another type, only when lookups are transparent.
+     * @param key object Hash accepts and KeyEqual compares to keys.
+     * @return A const iterator pointing to key's pair, end() if key isn't in the map.
+     */
+    template<class K, class = _transparent<K>>
+    const_iterator find(const K &key) const
+    {
+        size_t place = _locate(key);
+        return place == NO_SLOT ? end() : entries.begin() + place;
+    }
+
+    /**
+     * @return A const iterator pointing to the first inserted item in the map.
+     */
+    const_iterator begin() const
+    {
+        return entries.begin();
+    }
+
+    /**
+     * @return A const iterator pointing past the last inserted item in the map.
+     */
+    const_iterator end() const
+    {
+        return entries.end();
+    }
+
+    /**
+     * @return A const iterator pointing to the first inserted item in the map.
+     */
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+
+    /**
+     * @return A const iterator pointing past the last inserted item in the map.
+     */
+    const_iterator cend() const
+    {
+        return end();
+    }
+
+    /**
+     * @brief [] operator overload when <OrderedHashMap_name>[KeyT key] is called.
+     * @return reference to the ValueT item in the key place, appending a default one if
+     * the key isn't in the map.
+     */
+    ValueT &operator[](const KeyT &key)
+    {
+        return entries[_tryEmplace(key).first].second;
+    }
+
+    /**
+     * @brief [] operator overload when <OrderedHashMap_name>[KeyT key] is called on a const map.
+     * @return the ValueT item in the key place if it exists, a default ValueT otherwise.
+     */
+    ValueT operator[](const KeyT &key) const
+    {
+        size_t place = _locate(key);
+        return place == NO_SLOT ? ValueT() : entries[place].second;
+    }
+
+    /**
+     * @brief == operator overload, the order of insertion doesn't matter.
+     * @param other OrderedHashMap to compare to.
+     * @return true if both maps hold equal pairs, false otherwise.
+     */
+    bool operator==(const OrderedHashMap<KeyT, ValueT, Hash, KeyEqual> &other) const;
+
+    /**
+     * @brief != operator overload.
+     * @param other OrderedHashMap to compare to.
+     * @return true if the maps hold different pairs, false otherwise.
+     */
+    bool operator!=(const OrderedHashMap<KeyT, ValueT, Hash, KeyEqual> &other) const
+    {
+        return !(*this == other);
+    }
+};
+
+/**
+ * @brief Constructor that receives values in two separate vectors, a later pair of a
+ * repeated key replaces the value of the earlier one and keeps its place.
+ * @param keys const reference to KeyT object vector.
+ * @param values const reference to ValueT object vector.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+OrderedHashMap<KeyT, ValueT, Hash, KeyEqual>::OrderedHashMap(const std::vector<KeyT> &keys,
+                                                             const std::vector<ValueT> &values) :
+        OrderedHashMap()
+{
+    if (keys.size() != values.size())
+    {
+        throw std::runtime_error("Vector lengths aren't equal");
+    }
+    reserve(keys.size());
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        entries[_tryEmplace(keys[i]).first].second = values[i];
+    }
+}
+
+/**
+ * @brief Builds an OrderedHashMap from a list of pairs, a later pair of a repeated key
+ * replaces the value of the earlier one and keeps its place.
+ * @param list pairs to hold.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+OrderedHashMap<KeyT, ValueT, Hash, KeyEqual>::OrderedHashMap(std::initializer_list<pairType> list) :
+        OrderedHashMap()
+{
+    reserve(list.size());
+    for (const pairType &pair: list)
+    {
+        entries[_tryEmplace(pair.first).first].second = pair.second;
+    }
+}
+
+/**
+ * @brief Appends a pair unless its key is already in the map.
+ * @param key key of the pair.
+ * @param args arguments to construct ValueT from.
+ * @return position of key's pair in entries, and true if it was appended.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+template<class K, class... Args>
+std::pair<size_t, bool> OrderedHashMap<KeyT, ValueT, Hash, KeyEqual>::_tryEmplace(K &&key, Args &&... args)
+{
+    if (index.empty())
+    {
+        _reIndex(ORDERED_MIN_CAPACITY);
+    }
+    uint32_t hash = _hash(key);
+    size_t place = _probe(key, hash);
+    if (index[place].entry != NO_ENTRY)
+    {
+        return std::make_pair((size_t) index[place].entry, false);
+    }
+    if (entries.size() >= NO_ENTRY - 1)
+    {
+        throw std::length_error(TOO_MANY_PAIRS);
+    }
+    entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                         std::forward_as_tuple(std::forward<Args>(args)...));
+    index[place].entry = (uint32_t) (entries.size() - 1);
+    index[place].hash = hash;
+    if (2 * entries.size() > index.size())
+    {
+        _reIndex(2 * index.size());
+    }
+    return std::make_pair(entries.size() - 1, true);
+}
+
+/**
+ * @brief Empties an index slot, moving later slots of the same run back so that
+ * probes need no tombstones.
+ * @param hole index slot to empty.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+void OrderedHashMap<KeyT, ValueT, Hash, KeyEqual>::_removeSlot(size_t hole)
+{
+    size_t mask = index.size() - 1;
+    for (size_t next = (hole + 1) & mask; index[next].entry != NO_ENTRY; next = (next + 1) & mask)
+    {
+        // A slot may fill the hole only if the hole is on its probe, between its home and it.
+        size_t home = index[next].hash & mask;
+        if (((next - home) & mask) >= ((next - hole) & mask))
+        {
+            index[hole] = index[next];
+            hole = next;
+        }
+    }
+    index[hole].entry = NO_ENTRY;
+}
+
+/**
+ * @brief Builds a new index table from the folded hashes kept in the old one, without
+ * hashing any key.
+ * @param newCapacity size of the new table, a power of two above twice the size.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+void OrderedHashMap<KeyT, ValueT, Hash, KeyEqual>::_reIndex(size_t newCapacity)
+{
+    std::vector<IndexSlot> fresh(newCapacity, IndexSlot{NO_ENTRY, 0});
+    size_t mask = newCapacity - 1;
+    for (const IndexSlot &slot: index)
+    {
+        if (slot.entry != NO_ENTRY)
+        {
+            size_t place = slot.hash & mask;
+            while (fresh[place].entry != NO_ENTRY)
+            {
+                place = (place + 1) & mask;
+            }
+            fresh[place] = slot;
+        }
+    }
+    index.swap(fresh);
+}
+
+/**
+ * @brief Get value by key.
+ * @param key to search by.
+ * @return reference to ValueT object if the map contains key, throws exception otherwise.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+ValueT &OrderedHashMap<KeyT, ValueT, Hash, KeyEqual>::at(const KeyT &key)
+{
+    size_t place = _locate(key);
+    if (place == NO_SLOT)
+    {
+        throw std::out_of_range(KEY_DOES_NOT_EXIST);
+    }
+    return entries[place].second;
+}
+
+/**
+ * @brief Get value by key.
+ * @param key to search by.
+ * @return reference to ValueT object if the map contains key, throws exception otherwise.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+const ValueT &OrderedHashMap<KeyT, ValueT, Hash, KeyEqual>::at(const KeyT &key) const
+{
+    size_t place = _locate(key);
+    if (place == NO_SLOT)
+    {
+        throw std::out_of_range(KEY_DOES_NOT_EXIST);
+    }
+    return entries[place].second;
+}
+
+/**
+ * @brief Erases key and value, moving the later pairs one place back to keep the
+ * order, which takes time linear in the size.
+ * @param key to erase.
+ * @return true if erasure was successful, false otherwise.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+bool OrderedHashMap<KeyT, ValueT, Hash, KeyEqual>::erase(const KeyT &key)
+{
+    if (entries.empty())
+    {
+        return false;
+    }
+    size_t place = _probe(key, _hash(key));
+    uint32_t entry = index[place].entry;
+    if (entry == NO_ENTRY)
+    {
+        return false;
+    }
+    entries.erase(entries.begin() + entry);
+    _removeSlot(place);
+    if (entry != entries.size())
+    {
+        for (IndexSlot &slot: index)
+        {
+            if (slot.entry != NO_ENTRY && slot.entry > entry)
+            {
+                slot.entry--;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Erases key and value in constant time, moving the last pair into their place.
+ * @param key to erase.
+ * @return true if erasure was successful, false otherwise.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+bool OrderedHashMap<KeyT, ValueT, Hash, KeyEqual>::unordered_erase(const KeyT &key)
+{
+    if (entries.empty())
+    {
+        return false;
+    }
+    size_t place = _probe(key, _hash(key));
+    uint32_t entry = index[place].entry;
+    if (entry == NO_ENTRY)
+    {
+        return false;
+    }
+    uint32_t last = (uint32_t) (entries.size() - 1);
+    if (entry != last)
+    {
+        entries[entry] = std::move(entries[last]);
+        size_t mask = index.size() - 1;
+        size_t moved = _hash(entries[entry].first) & mask;
+        while (index[moved].entry != last)
+        {
+            moved = (moved + 1) & mask;
+        }
+        index[moved].entry = entry;
+    }
+    entries.pop_back();
+    _removeSlot(place);
+    return true;
+}
+
+/**
+ * @brief Erases all of the items, keeping the allocated memory.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+void OrderedHashMap<KeyT, ValueT, Hash, KeyEqual>::clear()
+{
+    entries.clear();
+    for (IndexSlot &slot: index)
+    {
+        slot.entry = NO_ENTRY;
+    }
+}
+
+/**
+ * @brief Makes room for a number of items, so that inserting them allocates nothing.
+ * @param items number of items the map should hold.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+void OrderedHashMap<KeyT, ValueT, Hash, KeyEqual>::reserve(size_type items)
+{
+    entries.reserve(items);
+    size_t newCapacity = ORDERED_MIN_CAPACITY;
+    while (newCapacity < 2 * items)
+    {
+        newCapacity *= 2;
+    }
+    if (newCapacity > index.size())
+    {
+        _reIndex(newCapacity);
+    }
+}
+
+/**
+ * @brief == operator overload, the order of insertion doesn't matter.
+ * @param other OrderedHashMap to compare to.
+ * @return true if both maps hold equal pairs, false otherwise.
+ */
+template<class KeyT, class ValueT, class Hash, class KeyEqual>
+bool OrderedHashMap<KeyT, ValueT, Hash, KeyEqual>::operator==(const OrderedHashMap<KeyT, ValueT, Hash, KeyEqual> &other) const
+{
+    if (size() != other.size())
+    {
+        return false;
+    }
+    for (const pairType &pair: entries)
+    {
+        size_t place = other._locate(pair.first);
+        if (place == NO_SLOT || !(other.entries[place].second == pair.second))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+#endif //CPP_EX3_ORDEREDHASHMAP_HPP
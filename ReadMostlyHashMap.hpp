@@ -0,0 +1,294 @@
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <stdexcept>
+#include "HashMap.hpp"
+
+#ifndef CPP_EX3_READMOSTLYHASHMAP_HPP
+#define CPP_EX3_READMOSTLYHASHMAP_HPP
+
+#define NUM_OF_READER_SLOTS 128
+
+#define READER_SLOT_ALIGNMENT 64
+
+/**
+ * @brief HashMap for read mostly workloads whose lookups never lock or wait.
+ * Readers look keys up in an immutable published HashMap. Writers build a new HashMap
+ * aside, publish it with one atomic pointer swap and reclaim the old one once every
+ * reader that could still see it has left, using two sets of per-thread reader counters
+ * flipped by an epoch (as in sleepable RCU). A reader only increments and decrements a
+ * counter of its own cache line, so read throughput scales with cores.
+ * Writes copy the whole table, they are meant for rare reloads and batches of updates.
+ * @tparam KeyT Objects to search ValueT by.
+ * @tparam ValueT Object to hold.
+ * @tparam Hash hash of KeyT objects.
+ * @tparam KeyEqual equality of KeyT objects.
+ */
+template<class KeyT, class ValueT, class Hash = DefaultHash<KeyT>, class KeyEqual = DefaultEqual<KeyT>>
+class ReadMostlyHashMap
+{
+private:
+    typedef HashMap<KeyT, ValueT, Hash, KeyEqual> tableType;
+
+    /**
+     * @brief Counters of the readers of one group of threads, one per epoch parity.
+     */
+    struct alignas(READER_SLOT_ALIGNMENT) ReaderSlot
+    {
+        std::atomic<long> active[2];
+    };
+
+    /**
+     * @brief Counts the calling thread as a reader while the object lives.
+     */
+    class ReadSection
+    {
+    private:
+        std::atomic<long> &counter;
+
+    public:
+        /**
+         * @brief Enters a read section, before the published table is loaded.
+         * @param owner map to read.
+         */
+        explicit ReadSection(const ReadMostlyHashMap &owner) :
+                counter(owner.readers[_threadSlot()].active[owner.epoch.load() & 1])
+        {
+            counter.fetch_add(1);
+        }
+
+        /**
+         * @brief Leaves the read section, the table must not be used afterwards.
+         */
+        ~ReadSection()
+        {
+            counter.fetch_sub(1, std::memory_order_release);
+        }
+    };
+
+    /**
+     * @brief Currently published table.
+     */
+    std::atomic<tableType *> current;
+
+    /**
+     * @brief Counts the grace periods, its parity tells new readers which counter to use.
+     */
+    std::atomic<unsigned long> epoch;
+
+    /**
+     * @brief Reader counters, a thread always uses the same slot.
+     */
+    mutable ReaderSlot readers[NUM_OF_READER_SLOTS];
+
+    /**
+     * @brief Serializes writers.
+     */
+    std::mutex writeLock;
+
+    /**
+     * @return index of the reader slot of the calling thread.
+     */
+    static int _threadSlot()
+    {
+        static std::atomic<unsigned int> nextSlot(0);
+        thread_local unsigned int slot = nextSlot.fetch_add(1);
+        return (int) (slot % NUM_OF_READER_SLOTS);
+    }
+
+    /**
+     * @brief Waits until no reader counted under the given parity is left.
+     * @param parity 0 or 1.
+     */
+    void _waitForReaders(unsigned long parity)
+    {
+        for (int i = 0; i < NUM_OF_READER_SLOTS; i++)
+        {
+            while (readers[i].active[parity].load() != 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    /**
+     * @brief Publishes a new table and frees the old one after a grace period.
+     * Must be called with writeLock held.
+     * @param table new table, owned by this map from now on.
+     */
+    void _publish(tableType *table)
+    {
+        tableType *old = current.exchange(table);
+        // A reader may have read the epoch right before the previous flip and still be
+        // about to load the old table, so both parities are drained, flipping before each.
+        for (int flip = 0; flip < 2; flip++)
+        {
+            unsigned long parity = epoch.fetch_add(1) & 1;
+            _waitForReaders(parity);
+        }
+        delete old;
+    }
+
+public:
+    /**
+     * @brief ReadMostlyHashMap constructor, publishes an empty table.
+     */
+    ReadMostlyHashMap() :
+            current(new tableType()), epoch(0)
+    {
+        for (ReaderSlot &slot: readers)
+        {
+            slot.active[0] = 0;
+            slot.active[1] = 0;
+        }
+    }
+
+    /**
+     * @brief ReadMostlyHashMap constructor publishing a given table.
+     * @param table initial content, moved into the map.
+     */
+    explicit ReadMostlyHashMap(tableType &&table) :
+            ReadMostlyHashMap()
+    {
+        reload(std::move(table));
+    }
+
+    ReadMostlyHashMap(const ReadMostlyHashMap &other) = delete;
+
+    ReadMostlyHashMap &operator=(const ReadMostlyHashMap &other) = delete;
+
+    /**
+     * @brief ReadMostlyHashMap destructor, no reader may be running.
+     */
+    ~ReadMostlyHashMap()
+    {
+        delete current.load();
+    }
+
+    /**
+     * @return number of items in the published table.
+     */
+    size_t size() const
+    {
+        ReadSection section(*this);
+        return current.load()->size();
+    }
+
+    /**
+     * @brief checks if a given key is contained in the published table, never blocks.
+     * @param key the key to search for.
+     * @return true if the map contains the key, false otherwise.
+     */
+    bool containsKey(const KeyT &key) const
+    {
+        ReadSection section(*this);
+        return current.load()->containsKey(key);
+    }
+
+    /**
+     * @brief Get value by key, never blocks.
+     * @param key to search by.
+     * @return copy of the value if the map contains key, throws exception otherwise.
+     */
+    ValueT at(const KeyT &key) const
+    {
+        ReadSection section(*this);
+        return current.load()->at(key);
+    }
+
+    /**
+     * @brief Get value by key without throwing, never blocks.
+     * @param key to search by.
+     * @param val set to a copy of the value if the map contains key.
+     * @return true if the map contains key, false otherwise.
+     */
+    bool find(const KeyT &key, ValueT &val) const
+    {
+        ReadSection section(*this);
+        const tableType *table = current.load();
+        auto place = table->find(key);
+        if (place == table->end())
+        {
+            return false;
+        }
+        val = place->second;
+        return true;
+    }
+
+    /**
+     * @brief Runs a function on the published table inside one read section, for reads
+     * that need a consistent view of several keys or iterate over the table.
+     * @param reader called with a const reference to the table, which it must not keep.
+     * @return what reader returns.
+     */
+    template<class Function>
+    auto read(Function reader) const -> decltype(reader(std::declval<const tableType &>()))
+    {
+        ReadSection section(*this);
+        return reader(static_cast<const tableType &>(*current.load()));
+    }
+
+    /**
+     * @brief Replaces the whole content of the map, readers see either the old content or
+     * the new one.
+     * @param table new content, moved into the map.
+     */
+    void reload(tableType &&table)
+    {
+        tableType *fresh = new tableType(std::move(table));
+        std::lock_guard<std::mutex> guard(writeLock);
+        _publish(fresh);
+    }
+
+    /**
+     * @brief Applies a batch of changes to a copy of the published table and publishes it.
+     * @param modify called with a reference to the copy.
+     */
+    template<class Function>
+    void update(Function modify)
+    {
+        std::lock_guard<std::mutex> guard(writeLock);
+        tableType *fresh = new tableType(*current.load());
+        try
+        {
+            modify(*fresh);
+        }
+        catch (...)
+        {
+            delete fresh;
+            throw;
+        }
+        _publish(fresh);
+    }
+
+    /**
+     * @brief inserts a new value, copying the table.
+     * @param key to locate value by.
+     * @param val value to input.
+     * @return true if insertion was successful, false if key was already in the map.
+     */
+    bool insert(const KeyT &key, const ValueT &val)
+    {
+        bool inserted = false;
+        update([&](tableType &table)
+               { inserted = table.insert(key, val); });
+        return inserted;
+    }
+
+    /**
+     * @brief Erases key and value, copying the table.
+     * @param key to erase.
+     * @return true if erasure was successful, false otherwise.
+     */
+    bool erase(const KeyT &key)
+    {
+        bool erased = false;
+        update([&](tableType &table)
+               { erased = table.erase(key); });
+        return erased;
+    }
+};
+
+
+#endif //CPP_EX3_READMOSTLYHASHMAP_HPP
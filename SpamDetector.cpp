@@ -2,7 +2,19 @@
 #include <string>
 #include <iostream>
 #include <fstream>
-#include "HashMap.hpp"
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <system_error>
+#include <functional>
+#include <filesystem>
+#include <algorithm>
+#include <climits>
+#include "OrderedHashMap.hpp"
+#include "AhoCorasick.hpp"
+#include "LowerCase.hpp"
 
 #define INVALID_INPUT "Invalid input"
 
@@ -16,17 +28,29 @@
 
 #define EXACTLY_TWO_COLS "Only exactly two columns allowed"
 
-/**
- * @brief Turns all letter in a string to lowercase, in place.
- * @param str the string to change.
- */
-void toLowerCase(std::string &str)
-{
-    for (char &c : str)
-    {
-        c = (char) tolower(c);
-    }
-}
+#define CHUNK_SIZE (1 << 16)
+
+#define BATCH_FLAG "--batch"
+
+#define MIN_BATCH_ARGS 5
+
+#define MAX_BATCH_ARGS 6
+
+#define BATCH_DATABASE_ARG_NUM 2
+
+#define BATCH_MESSAGES_ARG_NUM 3
+
+#define BATCH_THRESHOLD_ARG_NUM 4
+
+#define BATCH_THREADS_ARG_NUM 5
+
+#define STDIN_MESSAGES "-"
+
+#define MESSAGE_DELIMITER '\0'
+
+#define MAX_PENDING_MESSAGES 1024
+
+#define MAX_THREADS_PER_CORE 4
 
 /**
  * @brief Checks if a given string represents a none-negative integer.
@@ -45,7 +69,7 @@ bool isNoneNegativeInteger(const std::string &basicString)
     }
     for (char c:basicString)
     {
-        if (!isdigit(c))
+        if (c < '0' || c > '9')
         {
             return false;
         }
@@ -68,14 +92,13 @@ public:
      */
     explicit SpamDetector(std::ifstream &database)
     {
-        _map = new HashMap<std::string, int>();
+        OrderedHashMap<std::string, int> parsed;
         boost::char_separator<char> sep{","};
         std::string line;
         while (std::getline(database, line))
         {
             if (line.find_first_of(',') != line.find_last_of(','))
             {
-                delete (_map);
                 throw std::invalid_argument(EXACTLY_TWO_COLS);
             }
             tokenizer tok{line, sep};
@@ -91,7 +114,6 @@ public:
                     toLowerCase(expression);
                     if (expression.empty())
                     {
-                        delete (_map);
                         throw std::invalid_argument("Expression must not be empty");
                     }
                 }
@@ -99,7 +121,6 @@ public:
                 {
                     if (!isNoneNegativeInteger(*current))
                     {
-                        delete (_map);
                         throw std::invalid_argument(
                                 "Only none negative integers allowed as weights");
                     }
@@ -113,88 +134,495 @@ public:
             }
             if (counter != 2)
             {
-                delete (_map);
                 throw std::invalid_argument(EXACTLY_TWO_COLS);
             }
-            _map->insert(expression, weight);
+            parsed.insert(expression, weight);
+        }
+        _matcher = new AhoCorasick(parsed, true);
+    }
+
+    /**
+     * @brief Scores a message read from a stream, safe to call from several threads.
+     * The message is read and scored in chunks of CHUNK_SIZE bytes, the automaton state
+     * carries matches across chunks, so memory use doesn't grow with the message. The
+     * automaton ignores case itself, the chunks aren't lowercased first.
+     * @param messageFile stream to read the message from.
+     * @param limit reading stops as soon as the score reaches it, weights are never
+     * negative so the full score would reach it too.
+     * @return sum of the weights of all the occurrences of expressions in the message, or
+     * a sum of at least limit if it reached limit.
+     */
+    long long score(std::istream &messageFile, long long limit = LLONG_MAX) const
+    {
+        std::vector<char> chunk(CHUNK_SIZE);
+        long long score = 0;
+        uint32_t state = 0;
+        while (messageFile && score < limit)
+        {
+            messageFile.read(chunk.data(), CHUNK_SIZE);
+            auto length = (size_t) messageFile.gcount();
+            score += _matcher->score(chunk.data(), length, state, limit - score);
         }
+        // Reading lines used to end the message with a newline, which no expression can
+        // contain, so leaving it out changes no score.
+        return score;
+    }
+
+    /**
+     * @brief Scores a message held in memory, safe to call from several threads.
+     * @param message the message.
+     * @return sum of the weights of all the occurrences of expressions in the message.
+     */
+    long long score(const std::string &message) const
+    {
+        return _matcher->score(message);
     }
 
     /**
      * @brief checks if a given message is considered as spam
      * according to the object database and a given threshold.
      * prints SPAM if it is, prints NOT_SPAM otherwise.
+     * Stops reading the message once its score reaches the threshold.
      * @param messageFile inputFileStream to check if it is spam.
      * @param threshold positive number indicating minimum value to be considered as spam.
      */
     void detect(std::ifstream &messageFile, int threshold)
     {
-        int score = 0;
-        std::string message;
-        std::string line;
-        while (std::getline(messageFile, line))
+        if (score(messageFile, threshold) >= threshold)
         {
-            message += line + "\n";
+            std::cout << "SPAM" << std::endl;
         }
+        else
+        {
+            std::cout << "NOT_SPAM" << std::endl;
+        }
+    }
+
+    /**
+     * @brief SpamDetector destructor.
+     */
+    ~SpamDetector()
+    {
+        delete (_matcher);
+    }
 
-        toLowerCase(message);
-        for (const auto &i: *_map)
+private:
+    AhoCorasick *_matcher{};
+};
+
+/**
+ * @brief Scores many messages with one SpamDetector on a pool of worker threads, and
+ * prints a verdict and a score per message in the order the messages were given.
+ * At most MAX_PENDING_MESSAGES messages are queued or waiting to be printed at a time,
+ * so memory use doesn't grow with the number of messages.
+ */
+class BatchDetector
+{
+public:
+    /**
+     * @brief A message to score.
+     */
+    struct Message
+    {
+        /**
+         * @brief Name printed with the verdict, the path of the message if text is unused.
+         */
+        std::string name;
+
+        /**
+         * @brief Content of a message given in memory.
+         */
+        std::string text;
+    };
+
+    /**
+     * @brief BatchDetector constructor.
+     * @param detector detector to score with, shared by the workers.
+     * @param threshold positive number indicating minimum value to be considered as spam.
+     * @param inMemory true if messages are given by content, false if by path.
+     */
+    BatchDetector(const SpamDetector &detector, int threshold, bool inMemory) :
+            _detector(detector), _threshold(threshold), _inMemory(inMemory), _results(MAX_PENDING_MESSAGES)
+    {
+    }
+
+    /**
+     * @brief Scores all the messages a source gives and prints their verdicts in order.
+     * If the system can't start all the workers, runs with the ones it started.
+     * Throws std::system_error if it can't start any. Whatever it throws, the workers are
+     * stopped and joined first.
+     * @param threads number of worker threads, positive.
+     * @param nextMessage sets its argument to the next message and returns true, returns
+     * false once there are no more messages. Called on the calling thread only.
+     * @return true if all the message files could be read, false otherwise.
+     */
+    bool run(unsigned int threads, const std::function<bool(Message &)> &nextMessage)
+    {
+        // Joins the workers however run ends, a joinable thread left behind would terminate.
+        Workers workers(*this);
+        try
         {
-            size_t index = message.find(i.first);
-            while (index != std::string::npos)
+            for (unsigned int i = 0; i < threads; i++)
             {
-                score += i.second;
-                index = message.find(i.first, index + 1);
+                workers.threads.emplace_back(&BatchDetector::_work, this);
             }
         }
-        if (score >= threshold)
+        catch (std::system_error &e)
         {
-            std::cout << "SPAM" << std::endl;
+            if (workers.threads.empty())
+            {
+                throw;
+            }
         }
-        else
+        bool allValid = true;
+        size_t submitted = 0;
+        Message message;
+        while (nextMessage(message))
         {
-            std::cout << "NOT_SPAM" << std::endl;
+            std::unique_lock<std::mutex> guard(_lock);
+            while (submitted - _printed == MAX_PENDING_MESSAGES)
+            {
+                allValid &= _printNext(guard);
+            }
+            _results[submitted % MAX_PENDING_MESSAGES] = Result{message.name, 0, false, false};
+            _pending.emplace_back(submitted++, std::move(message));
+            _jobReady.notify_one();
         }
+        std::unique_lock<std::mutex> guard(_lock);
+        _closed = true;
+        _jobReady.notify_all();
+        while (_printed < submitted)
+        {
+            allValid &= _printNext(guard);
+        }
+        return allValid;
     }
 
+private:
     /**
-     * @brief SpamDetector destructor.
+     * @brief The worker threads of a run, closed and joined on destruction.
      */
-    ~SpamDetector()
+    class Workers
+    {
+    public:
+        /**
+         * @brief Workers constructor.
+         * @param batch BatchDetector the workers take messages from.
+         */
+        explicit Workers(BatchDetector &batch) :
+                _batch(batch)
+        {
+        }
+
+        /**
+         * @brief Closes the queue, dropping the messages no worker took, and waits for the
+         * workers to finish.
+         */
+        ~Workers()
+        {
+            {
+                std::lock_guard<std::mutex> guard(_batch._lock);
+                _batch._pending.clear();
+                _batch._closed = true;
+            }
+            _batch._jobReady.notify_all();
+            for (std::thread &worker: threads)
+            {
+                worker.join();
+            }
+        }
+
+        /**
+         * @brief Started worker threads.
+         */
+        std::vector<std::thread> threads;
+
+    private:
+        BatchDetector &_batch;
+    };
+
+    /**
+     * @brief Outcome of one message.
+     */
+    struct Result
+    {
+        std::string name;
+        long long score;
+        bool valid;
+        bool done;
+    };
+
+    const SpamDetector &_detector;
+
+    int _threshold;
+
+    bool _inMemory;
+
+    /**
+     * @brief Messages not taken by a worker yet, with their input positions.
+     */
+    std::deque<std::pair<size_t, Message>> _pending;
+
+    /**
+     * @brief Result of input position i is in _results[i % MAX_PENDING_MESSAGES].
+     */
+    std::vector<Result> _results;
+
+    /**
+     * @brief Number of results printed so far.
+     */
+    size_t _printed = 0;
+
+    /**
+     * @brief True once all the messages were queued.
+     */
+    bool _closed = false;
+
+    std::mutex _lock;
+
+    std::condition_variable _jobReady;
+
+    std::condition_variable _resultReady;
+
+    /**
+     * @brief Takes messages and scores them until all were queued and taken.
+     */
+    void _work()
     {
-        delete (_map);
+        std::unique_lock<std::mutex> guard(_lock);
+        while (true)
+        {
+            _jobReady.wait(guard, [this]
+            { return !_pending.empty() || _closed; });
+            if (_pending.empty())
+            {
+                return;
+            }
+            std::pair<size_t, Message> job = std::move(_pending.front());
+            _pending.pop_front();
+            guard.unlock();
+            bool valid = true;
+            long long score = 0;
+            if (_inMemory)
+            {
+                score = _detector.score(job.second.text);
+            }
+            else
+            {
+                std::ifstream messageFile(job.second.name);
+                valid = messageFile.is_open();
+                score = valid ? _detector.score(messageFile) : 0;
+            }
+            guard.lock();
+            Result &result = _results[job.first % MAX_PENDING_MESSAGES];
+            result.score = score;
+            result.valid = valid;
+            result.done = true;
+            _resultReady.notify_all();
+        }
     }
 
-private:
-    HashMap<std::string, int> *_map{};
+    /**
+     * @brief Waits for the result of the next position to print and prints it.
+     * @param guard holds _lock, released while printing.
+     * @return true if the message could be read, false otherwise.
+     */
+    bool _printNext(std::unique_lock<std::mutex> &guard)
+    {
+        Result &slot = _results[_printed % MAX_PENDING_MESSAGES];
+        _resultReady.wait(guard, [&slot]
+        { return slot.done; });
+        Result result = std::move(slot);
+        _printed++;
+        guard.unlock();
+        std::cout << result.name << '\t';
+        if (!result.valid)
+        {
+            std::cout << INVALID_INPUT << '\n';
+        }
+        else
+        {
+            std::cout << (result.score >= _threshold ? "SPAM" : "NOT_SPAM") << '\t' << result.score << '\n';
+        }
+        guard.lock();
+        return result.valid;
+    }
 };
 
 /**
- * @brief Main function of SpamDetector object for SpamDetector project.
- * parses database filename, message filename and a threshold value and prints to the screen
- * a message indicating if the given message was spam or not.
+ * @brief Parses a threshold argument.
+ * @param arg the argument.
+ * @param threshold set to the threshold.
+ * @return true if the argument is a positive integer, false otherwise.
+ */
+bool parseThreshold(const char *arg, int &threshold)
+{
+    try
+    {
+        threshold = std::stoi(arg);
+    }
+    catch (std::invalid_argument &e)
+    {
+        return false;
+    }
+    catch (std::out_of_range &e)
+    {
+        return false;
+    }
+    return threshold >= 1 && isNoneNegativeInteger(arg);
+}
+
+/**
+ * @brief Parses a number of worker threads argument.
+ * @param arg the argument.
+ * @param threads set to the number of threads.
+ * @return true if the argument is a positive integer of at most MAX_THREADS_PER_CORE
+ * threads per hardware thread, false otherwise.
+ */
+bool parseThreadCount(const char *arg, unsigned int &threads)
+{
+    int given = 0;
+    if (!parseThreshold(arg, given))
+    {
+        return false;
+    }
+    unsigned int most = std::max(std::thread::hardware_concurrency(), 1u) * MAX_THREADS_PER_CORE;
+    if ((unsigned int) given > most)
+    {
+        return false;
+    }
+    threads = (unsigned int) given;
+    return true;
+}
+
+/**
+ * @brief Batch mode of SpamDetector: builds one detector and scores many messages with it
+ * concurrently. Messages are the regular files of a directory in name order, the files a
+ * list file names one per line, or with STDIN_MESSAGES the contents read from the standard
+ * input separated by MESSAGE_DELIMITER. Prints a line per message, in input order, with
+ * its name, SPAM or NOT_SPAM and its score, or Invalid input if its file can't be read.
  * @param argc number of given arguments.
- * @param argv array of arguments.
+ * @param argv array of arguments, BATCH_FLAG first.
  * @return EXIT_SUCCESS if input was valid, EXIT_FAILURE otherwise.
  */
-int main(const int argc, const char **argv)
+int batchMain(const int argc, const char **argv)
 {
-    if (argc != EXPECTED_NUM_OF_ARGS)//todo including SpamDetector or not?
+    int threshold = 0;
+    if (!parseThreshold(argv[BATCH_THRESHOLD_ARG_NUM], threshold))
     {
-        std::cerr << "Usage: SpamDetector <database path> <message path> <threshold>" << std::endl;
+        std::cerr << INVALID_INPUT << std::endl;
         return EXIT_FAILURE;
     }
-    int threshold = 0;
+    unsigned int threads = std::max(std::thread::hardware_concurrency(), 1u);
+    if (argc == MAX_BATCH_ARGS && !parseThreadCount(argv[BATCH_THREADS_ARG_NUM], threads))
+    {
+        std::cerr << INVALID_INPUT << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::string source = argv[BATCH_MESSAGES_ARG_NUM];
+    std::vector<std::string> paths;
+    std::ifstream listFile;
+    std::error_code error;
+    if (source != STDIN_MESSAGES && std::filesystem::is_directory(source, error))
+    {
+        for (const auto &entry: std::filesystem::directory_iterator(source, error))
+        {
+            if (entry.is_regular_file(error))
+            {
+                paths.push_back(entry.path().string());
+            }
+        }
+        std::sort(paths.begin(), paths.end());
+    }
+    else if (source != STDIN_MESSAGES)
+    {
+        listFile.open(source);
+        if (!listFile.is_open())
+        {
+            std::cerr << INVALID_INPUT << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    std::ifstream databaseFile(argv[BATCH_DATABASE_ARG_NUM]);
+    if (!databaseFile.is_open())
+    {
+        std::cerr << INVALID_INPUT << std::endl;
+        return EXIT_FAILURE;
+    }
+    bool allValid = false;
     try
     {
-        threshold = std::stoi(argv[THRESHOLD_ARG_NUM]);
+        SpamDetector detector(databaseFile);
+        BatchDetector batch(detector, threshold, source == STDIN_MESSAGES);
+        size_t next = 0;
+        allValid = batch.run(threads, [&](BatchDetector::Message &message)
+        {
+            if (source == STDIN_MESSAGES)
+            {
+                message.name = std::to_string(++next);
+                return (bool) std::getline(std::cin, message.text, MESSAGE_DELIMITER);
+            }
+            if (listFile.is_open())
+            {
+                while (std::getline(listFile, message.name))
+                {
+                    if (!message.name.empty())
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+            if (next == paths.size())
+            {
+                return false;
+            }
+            message.name = paths[next++];
+            return true;
+        });
     }
     catch (std::invalid_argument &e)
     {
         std::cerr << INVALID_INPUT << std::endl;
         return EXIT_FAILURE;
     }
-    if (threshold < 1 || !isNoneNegativeInteger(argv[THRESHOLD_ARG_NUM]))
+    catch (std::system_error &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout.flush();
+    if (!allValid)
+    {
+        std::cerr << INVALID_INPUT << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Main function of SpamDetector object for SpamDetector project.
+ * parses database filename, message filename and a threshold value and prints to the screen
+ * a message indicating if the given message was spam or not.
+ * @param argc number of given arguments.
+ * @param argv array of arguments.
+ * @return EXIT_SUCCESS if input was valid, EXIT_FAILURE otherwise.
+ */
+int main(const int argc, const char **argv)
+{
+    if (argc > 1 && std::string(argv[1]) == BATCH_FLAG && argc >= MIN_BATCH_ARGS && argc <= MAX_BATCH_ARGS)
+    {
+        return batchMain(argc, argv);
+    }
+    if (argc != EXPECTED_NUM_OF_ARGS)//todo including SpamDetector or not?
+    {
+        std::cerr << "Usage: SpamDetector <database path> <message path> <threshold>" << std::endl;
+        std::cerr << "       SpamDetector " BATCH_FLAG " <database path> <directory | list file | "
+                  STDIN_MESSAGES "> <threshold> [threads]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    int threshold = 0;
+    if (!parseThreshold(argv[THRESHOLD_ARG_NUM], threshold))
     {
         std::cerr << INVALID_INPUT << std::endl;
         return EXIT_FAILURE;
@@ -0,0 +1,123 @@
+//
+// Benchmark: messages per second through SpamDetector's batch mode at several thread
+// counts, against running one SpamDetector process per message.
+// Build: g++ -std=c++17 -O2 -I.. BatchBench.cpp -o BatchBench
+// Run:   ./BatchBench <SpamDetector binary> [messages = 20000]
+// Writes a database of EXPRESSIONS expressions and the messages, each of MESSAGE_WORDS
+// random words, to a temporary directory, runs the binary on them with its output thrown
+// away, and prints messages per second. Batch mode runs with 1 thread and doubling up to
+// the most it accepts, MAX_THREADS_PER_CORE per hardware thread. The process per message
+// runs on the first PROCESS_MESSAGES messages only.
+//
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#define EXPRESSIONS 1000
+
+#define MESSAGE_WORDS 50
+
+#define THRESHOLD "20"
+
+#define MAX_THREADS_PER_CORE 4
+
+#define PROCESS_MESSAGES 500
+
+/**
+ * @return seconds since some fixed point.
+ */
+static double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @param random generator to draw from.
+ * @return random lowercase word of 3 to 10 letters.
+ */
+static std::string randomWord(std::mt19937_64 &random)
+{
+    std::string word(3 + random() % 8, 'a');
+    for (char &c: word)
+    {
+        c = (char) ('a' + random() % 26);
+    }
+    return word;
+}
+
+/**
+ * @brief Runs a shell command with its output thrown away.
+ * @param command command to run.
+ * @return seconds the command took.
+ */
+static double timeCommand(const std::string &command)
+{
+    double start = now();
+    if (std::system((command + " > /dev/null").c_str()) != 0)
+    {
+        std::cerr << "failed: " << command << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+    return now() - start;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: BatchBench <SpamDetector binary> [messages]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::string binary = std::filesystem::absolute(argv[1]).string();
+    size_t numOfMessages = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20000;
+    std::filesystem::path directory = std::filesystem::temp_directory_path() /
+                                      ("BatchBench." + std::to_string(getpid()));
+    std::filesystem::path messages = directory / "messages", database = directory / "database.csv";
+    std::filesystem::create_directories(messages);
+
+    std::mt19937_64 random(42);
+    std::vector<std::string> expressions;
+    std::ofstream databaseFile(database);
+    for (int i = 0; i < EXPRESSIONS; i++)
+    {
+        expressions.push_back(randomWord(random));
+        databaseFile << expressions.back() << "," << 1 + random() % 9 << "\n";
+    }
+    databaseFile.close();
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < numOfMessages; i++)
+    {
+        paths.push_back((messages / ("message" + std::to_string(i) + ".txt")).string());
+        std::ofstream messageFile(paths.back());
+        for (int word = 0; word < MESSAGE_WORDS; word++)
+        {
+            messageFile << (random() % 10 == 0 ? expressions[random() % EXPRESSIONS] : randomWord(random)) << " ";
+        }
+    }
+
+    std::cout << std::thread::hardware_concurrency() << " hardware threads, " << numOfMessages
+              << " messages, messages/s" << std::endl;
+    unsigned int most = std::max(std::thread::hardware_concurrency(), 1u) * MAX_THREADS_PER_CORE;
+    for (unsigned int threads = 1; threads <= most; threads *= 2)
+    {
+        double seconds = timeCommand("'" + binary + "' --batch '" + database.string() + "' '" + messages.string() +
+                                     "' " THRESHOLD " " + std::to_string(threads));
+        std::cout << "batch, " << threads << " threads\t" << (double) numOfMessages / seconds << std::endl;
+    }
+    size_t processes = std::min((size_t) PROCESS_MESSAGES, numOfMessages);
+    double start = now();
+    for (size_t i = 0; i < processes; i++)
+    {
+        timeCommand("'" + binary + "' '" + database.string() + "' '" + paths[i] + "' " THRESHOLD);
+    }
+    std::cout << "process per message\t" << (double) processes / (now() - start) << std::endl;
+    std::filesystem::remove_all(directory);
+    return 0;
+}
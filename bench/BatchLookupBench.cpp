@@ -0,0 +1,226 @@
+//
+// Benchmark: looking keys up in batches, every key of a batch hashed and its home slot
+// prefetched before any is probed, against looking them up one by one, for batch sizes 1
+// to MAX_BATCH. This is how the insert_bulk and find_batch removed from HashMap worked.
+// Build: g++ -std=c++17 -O2 -I.. BatchLookupBench.cpp -o BatchLookupBench
+// Run:   ./BatchLookupBench [pairs = 4000000]
+// Prefetching needs the table's arrays, which HashMap keeps private, so the batches run on
+// ProbeTable below: control bytes, hashes and slots in three arrays as in HashMap, the same
+// hash, home slot and load factor, probed one control byte at a time. HashMap::find on the
+// same keys is printed too, as a reference. Queries are the keys in random order. Prints
+// ns per lookup, the best of REPEATS runs.
+//
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../HashMap.hpp"
+
+#define MAX_BATCH 64
+
+#define REPEATS 3
+
+#define EMPTY_CTRL (-128)
+
+#define HOME_SHIFT 7
+
+static volatile uint64_t sink;
+
+/**
+ * @return seconds since some fixed point.
+ */
+static double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Open addressing table laid out as HashMap's, with inserts and lookups only.
+ */
+class ProbeTable
+{
+public:
+    /**
+     * @brief Constructor of an empty table.
+     * @param capacity number of slots, a power of two.
+     */
+    explicit ProbeTable(size_t capacity) :
+            ctrl(capacity, (signed char) EMPTY_CTRL), hashes(capacity), slots(capacity), mask(capacity - 1)
+    {
+    }
+
+    /**
+     * @param key to hash.
+     * @return full hash of key, as HashMap computes it.
+     */
+    static size_t hash(uint64_t key)
+    {
+        return IntegerHash()(key);
+    }
+
+    /**
+     * @brief Inserts a key missing from the table.
+     * @param key to insert.
+     * @param value of key.
+     */
+    void insert(uint64_t key, uint64_t value)
+    {
+        size_t keyHash = hash(key), slot = home(keyHash);
+        while (ctrl[slot] != EMPTY_CTRL)
+        {
+            slot = (slot + 1) & mask;
+        }
+        ctrl[slot] = (signed char) (keyHash & 0x7f);
+        hashes[slot] = keyHash;
+        slots[slot] = {key, value};
+    }
+
+    /**
+     * @brief Prefetches the control byte, hash and slot a key's probe sequence starts at.
+     * @param keyHash full hash of the key.
+     */
+    void prefetch(size_t keyHash) const
+    {
+        size_t slot = home(keyHash);
+        __builtin_prefetch(&ctrl[slot]);
+        __builtin_prefetch(&hashes[slot]);
+        __builtin_prefetch(&slots[slot]);
+    }
+
+    /**
+     * @param key to look for.
+     * @param keyHash full hash of key.
+     * @return pointer to the value of key, nullptr if key isn't in the table.
+     */
+    const uint64_t *find(uint64_t key, size_t keyHash) const
+    {
+        signed char fragment = (signed char) (keyHash & 0x7f);
+        for (size_t slot = home(keyHash); ctrl[slot] != EMPTY_CTRL; slot = (slot + 1) & mask)
+        {
+            if (ctrl[slot] == fragment && hashes[slot] == keyHash && slots[slot].first == key)
+            {
+                return &slots[slot].second;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    /**
+     * @param keyHash full hash of a key.
+     * @return slot the key's probe sequence starts at.
+     */
+    size_t home(size_t keyHash) const
+    {
+        return (keyHash >> HOME_SHIFT) & mask;
+    }
+
+    /**
+     * @brief Control byte of every slot, EMPTY_CTRL or the low bits of the key's hash.
+     */
+    std::vector<signed char> ctrl;
+
+    /**
+     * @brief Full hash of the key in every full slot.
+     */
+    std::vector<size_t> hashes;
+
+    /**
+     * @brief Key and value of every full slot.
+     */
+    std::vector<std::pair<uint64_t, uint64_t>> slots;
+
+    /**
+     * @brief Number of slots minus one.
+     */
+    size_t mask;
+};
+
+/**
+ * @brief Times a way of looking all queries up.
+ * @param name printed name.
+ * @param queries keys to look up.
+ * @param lookup looks all queries up, returns a number to keep it from being optimized out.
+ */
+template<class Lookup>
+static void run(const std::string &name, const std::vector<uint64_t> &queries, Lookup lookup)
+{
+    double best = 1e30;
+    for (int repeat = 0; repeat < REPEATS; repeat++)
+    {
+        double start = now();
+        sink = lookup();
+        best = std::min(best, now() - start);
+    }
+    std::cout << name << "\t" << best * 1e9 / (double) queries.size() << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t pairs = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    std::mt19937_64 random(42);
+    std::vector<uint64_t> keys(pairs);
+    for (uint64_t &key: keys)
+    {
+        key = random();
+    }
+    HashMap<uint64_t, uint64_t> map;
+    for (size_t i = 0; i < pairs; i++)
+    {
+        map.insert(keys[i], i);
+    }
+    ProbeTable table(map.capacity());
+    for (size_t i = 0; i < pairs; i++)
+    {
+        table.insert(keys[i], i);
+    }
+    std::vector<uint64_t> queries = keys;
+    std::shuffle(queries.begin(), queries.end(), random);
+
+    std::cout << pairs << " pairs, " << map.capacity() << " slots, ns per lookup" << std::endl;
+    run("HashMap::find", queries, [&map, &queries]()
+    {
+        uint64_t sum = 0;
+        for (uint64_t query: queries)
+        {
+            sum += map.find(query)->second;
+        }
+        return sum;
+    });
+    run("one by one", queries, [&table, &queries]()
+    {
+        uint64_t sum = 0;
+        for (uint64_t query: queries)
+        {
+            sum += *table.find(query, ProbeTable::hash(query));
+        }
+        return sum;
+    });
+    for (size_t batch = 1; batch <= MAX_BATCH; batch *= 2)
+    {
+        run("batch " + std::to_string(batch), queries, [&table, &queries, batch]()
+        {
+            uint64_t sum = 0;
+            size_t hashes[MAX_BATCH];
+            for (size_t start = 0; start < queries.size(); start += batch)
+            {
+                size_t size = std::min(batch, queries.size() - start);
+                for (size_t i = 0; i < size; i++)
+                {
+                    hashes[i] = ProbeTable::hash(queries[start + i]);
+                    table.prefetch(hashes[i]);
+                }
+                for (size_t i = 0; i < size; i++)
+                {
+                    sum += *table.find(queries[start + i], hashes[i]);
+                }
+            }
+            return sum;
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+//
+// Benchmark: ConcurrentHashMap against one HashMap behind a global std::mutex, from 1 to
+// 64 threads, on ingestion (every operation an upsert) and on a 90% read mix.
+// Build: g++ -std=c++17 -O2 -pthread -I.. ConcurrentBench.cpp -o ConcurrentBench
+// Run:   ./ConcurrentBench [operations = 4000000] [keys = 1000000]
+// The operations are split between the threads. Prints millions of operations per second.
+//
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "../ConcurrentHashMap.hpp"
+
+#define MAX_THREADS 64
+
+#define READ_PERCENT 90
+
+static std::atomic<uint64_t> sink(0);
+
+/**
+ * @brief One HashMap behind one mutex, the way the maps were shared before.
+ */
+class LockedHashMap
+{
+private:
+    mutable std::mutex lock;
+    HashMap<uint64_t, uint64_t> map;
+
+public:
+    bool find(uint64_t key, uint64_t &val) const
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto found = map.find(key);
+        if (found == map.end())
+        {
+            return false;
+        }
+        val = found->second;
+        return true;
+    }
+
+    template<class Function>
+    void upsert(uint64_t key, Function update)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        update(map[key]);
+    }
+};
+
+/**
+ * @return seconds since some fixed point.
+ */
+static double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Runs operations split between threads on a map holding the keys.
+ * @param threads number of threads.
+ * @param operations total number of operations.
+ * @param keys keys operated on.
+ * @param readPercent percent of the operations that are lookups, the others are upserts.
+ * @return millions of operations per second.
+ */
+template<class Map>
+static double run(int threads, size_t operations, const std::vector<uint64_t> &keys, int readPercent)
+{
+    Map map;
+    for (uint64_t key: keys)
+    {
+        map.upsert(key, [](uint64_t &value)
+        { value = 1; });
+    }
+    std::vector<std::thread> workers;
+    double start = now();
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&map, &keys, t, threads, operations, readPercent]()
+                             {
+                                 std::mt19937_64 random((uint64_t) t + 1);
+                                 uint64_t sum = 0;
+                                 for (size_t i = t; i < operations; i += threads)
+                                 {
+                                     uint64_t choice = random();
+                                     uint64_t key = keys[(choice >> 8) % keys.size()];
+                                     if ((int) (choice & 0xFF) * 100 < readPercent * 256)
+                                     {
+                                         uint64_t value = 0;
+                                         map.find(key, value);
+                                         sum += value;
+                                     }
+                                     else
+                                     {
+                                         map.upsert(key, [](uint64_t &value)
+                                         { value++; });
+                                     }
+                                 }
+                                 sink += sum;
+                             });
+    }
+    for (std::thread &worker: workers)
+    {
+        worker.join();
+    }
+    return (double) operations / (now() - start) / 1e6;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t operations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    size_t numOfKeys = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+    std::mt19937_64 random(42);
+    std::vector<uint64_t> keys(numOfKeys);
+    for (uint64_t &key: keys)
+    {
+        key = random();
+    }
+    std::cout << std::thread::hardware_concurrency() << " hardware threads, " << operations << " operations on "
+              << numOfKeys << " keys, Mops/s" << std::endl;
+    std::cout << "threads\tupsert: mutex\tsharded\t" << READ_PERCENT << "% reads: mutex\tsharded" << std::endl;
+    for (int threads = 1; threads <= MAX_THREADS; threads *= 2)
+    {
+        std::cout << threads << "\t" << run<LockedHashMap>(threads, operations, keys, 0) << "\t"
+                  << run<ConcurrentHashMap<uint64_t, uint64_t>>(threads, operations, keys, 0) << "\t"
+                  << run<LockedHashMap>(threads, operations, keys, READ_PERCENT) << "\t"
+                  << run<ConcurrentHashMap<uint64_t, uint64_t>>(threads, operations, keys, READ_PERCENT)
+                  << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,137 @@
+//
+// Benchmark: case folding of messages, alone and followed by scoring, at several message
+// sizes: std::tolower byte by byte as SpamDetector used to, toLowerCase with SIMD, and the
+// automaton folding each byte itself as it scans.
+// Build: g++ -std=c++17 -O2 -I.. FoldBench.cpp -o FoldBench
+// Run:   ./FoldBench [expressions = 200000]
+// Messages are random words of mixed case letters. Each size is folded or scanned until
+// at least MIN_BYTES bytes went by, and the best of REPEATS runs is printed in ns per byte:
+//   tolower        std::tolower on a copy of the message,
+//   toLowerCase    toLowerCase on a copy of the message,
+//   tolower+scan   std::tolower copy, then a case sensitive automaton,
+//   fold+scan      toLowerCase copy, then a case sensitive automaton,
+//   fused scan     the case ignoring automaton on the message as is.
+//
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include "../AhoCorasick.hpp"
+#include "../LowerCase.hpp"
+#include "../OrderedHashMap.hpp"
+
+#define MIN_BYTES (64 << 20)
+
+#define REPEATS 3
+
+static volatile long long sink;
+
+/**
+ * @return seconds since some fixed point.
+ */
+static double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @param random generator to draw from.
+ * @param upper true to mix uppercase letters in.
+ * @return random word of 4 to 20 letters.
+ */
+static std::string randomWord(std::mt19937_64 &random, bool upper)
+{
+    std::string word(4 + random() % 17, 'a');
+    for (char &c: word)
+    {
+        c = (char) ((upper && random() % 2 ? 'A' : 'a') + random() % 26);
+    }
+    return word;
+}
+
+/**
+ * @brief Prints the time one way of handling a message takes per byte.
+ * @param message the message.
+ * @param handle handles one message, returns a number to keep it from being optimized out.
+ */
+template<class Handle>
+static void run(const std::string &message, Handle handle)
+{
+    size_t rounds = std::max((size_t) 1, MIN_BYTES / message.size());
+    double best = 1e30;
+    for (int repeat = 0; repeat < REPEATS; repeat++)
+    {
+        long long sum = 0;
+        double start = now();
+        for (size_t round = 0; round < rounds; round++)
+        {
+            sum += handle(message);
+        }
+        best = std::min(best, now() - start);
+        sink = sum;
+    }
+    std::cout << "\t" << best * 1e9 / (double) (rounds * message.size());
+}
+
+int main(int argc, char *argv[])
+{
+    size_t numOfExpressions = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    std::mt19937_64 random(42);
+    OrderedHashMap<std::string, int> database;
+    while (database.size() < numOfExpressions)
+    {
+        database.insert(randomWord(random, false), (int) (1 + random() % 9));
+    }
+    AhoCorasick exact(database), ignoreCase(database, true);
+    std::cout << numOfExpressions << " expressions, ns per byte" << std::endl;
+    std::cout << "message\ttolower\ttoLowerCase\ttolower+scan\tfold+scan\tfused scan" << std::endl;
+    for (size_t bytes: {(size_t) 1 << 10, (size_t) 64 << 10, (size_t) 1 << 20, (size_t) 32 << 20})
+    {
+        std::string message;
+        while (message.size() < bytes)
+        {
+            message += randomWord(random, true) + " ";
+        }
+        message.resize(bytes);
+        std::cout << (bytes >> 10) << " KB";
+        run(message, [](const std::string &text)
+        {
+            std::string copy = text;
+            for (char &c: copy)
+            {
+                c = (char) std::tolower(c);
+            }
+            return (long long) copy[copy.size() / 2];
+        });
+        run(message, [](const std::string &text)
+        {
+            std::string copy = text;
+            toLowerCase(copy);
+            return (long long) copy[copy.size() / 2];
+        });
+        run(message, [&exact](const std::string &text)
+        {
+            std::string copy = text;
+            for (char &c: copy)
+            {
+                c = (char) std::tolower(c);
+            }
+            return exact.score(copy);
+        });
+        run(message, [&exact](const std::string &text)
+        {
+            std::string copy = text;
+            toLowerCase(copy);
+            return exact.score(copy);
+        });
+        run(message, [&ignoreCase](const std::string &text)
+        {
+            return ignoreCase.score(text);
+        });
+        std::cout << std::endl;
+    }
+    return 0;
+}
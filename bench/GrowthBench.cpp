@@ -0,0 +1,99 @@
+//
+// Benchmark: growing a HashMap from empty to 10M std::string keys. Every rehash moves the
+// pairs by their cached hashes, so the key hash runs once per insertion. Without the cache
+// the same rehashes would hash every pair they move again. The benchmark prints that count
+// and times hashing those keys.
+// Build: g++ -std=c++17 -O2 -I.. GrowthBench.cpp -o GrowthBench
+// Run:   ./GrowthBench [keys = 10000000]
+//
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../HashMap.hpp"
+
+static size_t hashCalls = 0;
+
+static volatile size_t sink;
+
+/**
+ * @brief StringHash counting its calls.
+ */
+struct CountingHash
+{
+    typedef void is_avalanching;
+
+    size_t operator()(const std::string &key) const
+    {
+        hashCalls++;
+        return StringHash()(key);
+    }
+};
+
+/**
+ * @return seconds since some fixed point.
+ */
+static double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char *argv[])
+{
+    size_t numOfKeys = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    std::mt19937_64 random(42);
+    std::vector<std::string> keys(numOfKeys);
+    for (std::string &key: keys)
+    {
+        key = "dictionary-entry:" + std::to_string(random());
+    }
+
+    std::vector<size_t> rehashSizes;
+    size_t moved = 0;
+    double grown;
+    {
+        HashMap<std::string, int, CountingHash> map;
+        double start = now();
+        for (size_t i = 0; i < numOfKeys; i++)
+        {
+            size_t before = map.capacity();
+            map.insert(keys[i], (int) i);
+            if (map.capacity() != before)
+            {
+                moved += i;
+                rehashSizes.push_back(i);
+            }
+        }
+        grown = now() - start;
+        std::cout << "growth from empty:  " << grown << " s, " << rehashSizes.size() << " rehashes moving " << moved
+                  << " pairs, " << hashCalls << " hash calls" << std::endl;
+    }
+    {
+        HashMap<std::string, int, CountingHash> map;
+        double start = now();
+        map.reserve(numOfKeys);
+        for (size_t i = 0; i < numOfKeys; i++)
+        {
+            map.insert(keys[i], (int) i);
+        }
+        double reserved = now() - start;
+        std::cout << "reserved up front:  " << reserved << " s, so the rehashes took " << grown - reserved << " s"
+                  << std::endl;
+    }
+    // A rehash moves the keys inserted before it. Hashing them again from the key vector,
+    // read in order, is a lower bound of what the rehashes spent on it without the cache.
+    double start = now();
+    size_t sum = 0;
+    for (size_t pairs: rehashSizes)
+    {
+        for (size_t i = 0; i < pairs; i++)
+        {
+            sum += StringHash()(keys[i]);
+        }
+    }
+    sink = sum;
+    std::cout << "without the cache:  " << moved << " more hash calls, " << now() - start << " s more" << std::endl;
+    return 0;
+}
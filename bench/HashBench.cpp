@@ -0,0 +1,178 @@
+//
+// Benchmark: the bundled hashers against std::hash, for the spread of their hashes over
+// the home slots of a table and for their speed.
+// Build: g++ -std=c++17 -O2 -I.. HashBench.cpp -o HashBench
+// Run:   ./HashBench
+// Spread: DISTRIBUTION_KEYS keys over 2^DISTRIBUTION_BITS home slots, taken from the hash
+// bits HashMap uses. Prints the variance of the slot loads over the variance of uniformly
+// random slots, 1 for an ideal hash, and the fullest slot.
+// Table: inserting and finding TABLE_KEYS keys in a HashMap using each hash as is.
+// Speed: ns per hash of int keys and of strings of several lengths.
+//
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../HashMap.hpp"
+
+#define DISTRIBUTION_BITS 16
+
+#define DISTRIBUTION_KEYS (1 << 18)
+
+#define TABLE_KEYS 20000
+
+#define SPEED_BYTES (64 << 20)
+
+static volatile size_t sink;
+
+/**
+ * @brief libstdc++'s std::hash, declared avalanching so HashMap uses it without mixing it,
+ * as HashMap used it before the bundled hashers.
+ */
+template<class KeyT>
+struct RawStdHash : std::hash<KeyT>
+{
+    typedef void is_avalanching;
+};
+
+/**
+ * @return seconds since some fixed point.
+ */
+static double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Prints how evenly a hash spreads keys over the home slots of a table.
+ * @param name printed name of the hash and keys.
+ * @param keys keys to spread.
+ * @param hash hash to test.
+ */
+template<class KeyT, class H>
+static void spread(const char *name, const std::vector<KeyT> &keys, H hash)
+{
+    std::vector<unsigned> loads((size_t) 1 << DISTRIBUTION_BITS, 0);
+    for (const KeyT &key: keys)
+    {
+        loads[(hash(key) >> FRAGMENT_BITS) & (loads.size() - 1)]++;
+    }
+    double mean = (double) keys.size() / (double) loads.size(), variance = 0;
+    for (unsigned load: loads)
+    {
+        variance += (load - mean) * (load - mean);
+    }
+    variance /= (double) loads.size();
+    // Slot loads of uniformly random keys are binomial.
+    double expected = mean * (1 - 1.0 / (double) loads.size());
+    std::cout << "  " << name << "\tvariance ratio " << variance / expected << "\tfullest slot "
+              << *std::max_element(loads.begin(), loads.end()) << " (mean " << mean << ")" << std::endl;
+}
+
+/**
+ * @brief Prints the time to insert and to find keys in a HashMap using a hash.
+ * @param name printed name of the hash and keys.
+ * @param keys keys to insert.
+ */
+template<class H, class KeyT>
+static void table(const char *name, const std::vector<KeyT> &keys)
+{
+    HashMap<KeyT, int, H> map;
+    double start = now();
+    for (const KeyT &key: keys)
+    {
+        map.insert(key, 1);
+    }
+    double inserted = now();
+    size_t found = 0;
+    for (const KeyT &key: keys)
+    {
+        found += map.containsKey(key);
+    }
+    double end = now();
+    sink = found;
+    std::cout << "  " << name << "\tinsert " << (inserted - start) * 1e9 / (double) keys.size() << "\tfind "
+              << (end - inserted) * 1e9 / (double) keys.size() << " ns/key" << std::endl;
+}
+
+/**
+ * @brief Prints the time a hash takes per key.
+ * @param name printed name of the hash and keys.
+ * @param keys keys to hash, hashed again and again.
+ * @param rounds number of times to hash all keys.
+ * @param hash hash to time.
+ */
+template<class KeyT, class H>
+static void speed(const char *name, const std::vector<KeyT> &keys, size_t rounds, H hash)
+{
+    size_t sum = 0;
+    double start = now();
+    for (size_t round = 0; round < rounds; round++)
+    {
+        for (const KeyT &key: keys)
+        {
+            sum += hash(key);
+        }
+    }
+    double seconds = now() - start;
+    sink = sum;
+    std::cout << "  " << name << "\t" << seconds * 1e9 / (double) (rounds * keys.size()) << " ns/hash" << std::endl;
+}
+
+int main()
+{
+    std::mt19937_64 random(42);
+    std::vector<uint64_t> sequential, strided, randomKeys;
+    std::vector<std::string> words;
+    for (uint64_t i = 0; i < DISTRIBUTION_KEYS; i++)
+    {
+        sequential.push_back(i);
+        // Multiples of a large power of two, as in ids with a shard number in the low bits.
+        strided.push_back(i << 24);
+        randomKeys.push_back(random());
+        words.push_back("user" + std::to_string(i));
+    }
+    std::cout << "spread of " << DISTRIBUTION_KEYS << " keys over 2^" << DISTRIBUTION_BITS << " home slots:"
+              << std::endl;
+    spread("std::hash sequential", sequential, std::hash<uint64_t>());
+    spread("IntegerHash sequential", sequential, IntegerHash());
+    spread("std::hash strided", strided, std::hash<uint64_t>());
+    spread("IntegerHash strided", strided, IntegerHash());
+    spread("std::hash random", randomKeys, std::hash<uint64_t>());
+    spread("IntegerHash random", randomKeys, IntegerHash());
+    spread("std::hash words", words, std::hash<std::string>());
+    spread("StringHash words", words, StringHash());
+
+    std::cout << TABLE_KEYS << " keys in a HashMap:" << std::endl;
+    std::vector<uint64_t> tableSequential(sequential.begin(), sequential.begin() + TABLE_KEYS);
+    std::vector<uint64_t> tableStrided(strided.begin(), strided.begin() + TABLE_KEYS);
+    table<RawStdHash<uint64_t>>("std::hash sequential", tableSequential);
+    table<IntegerHash>("IntegerHash sequential", tableSequential);
+    table<RawStdHash<uint64_t>>("std::hash strided", tableStrided);
+    table<IntegerHash>("IntegerHash strided", tableStrided);
+
+    std::cout << "speed:" << std::endl;
+    speed("std::hash uint64_t", randomKeys, 16, std::hash<uint64_t>());
+    speed("IntegerHash uint64_t", randomKeys, 16, IntegerHash());
+    for (size_t length: {8, 32, 256, 4096})
+    {
+        std::vector<std::string> strings(std::max((size_t) 1, ((size_t) 1 << 20) / length));
+        for (std::string &s: strings)
+        {
+            s.resize(length);
+            for (char &c: s)
+            {
+                c = (char) ('a' + random() % 26);
+            }
+        }
+        size_t rounds = SPEED_BYTES / (strings.size() * length);
+        std::string suffix = " " + std::to_string(length) + " bytes";
+        speed(("std::hash" + suffix).c_str(), strings, rounds, std::hash<std::string>());
+        speed(("StringHash" + suffix).c_str(), strings, rounds, StringHash());
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+//
+// Benchmark: tail latency of single operations on HashMap, with the default rehashing and
+// with incremental rehashing, where growing, shrinking and cleaning tombstones should not
+// stall one operation for a whole rehash.
+// Build: g++ -std=c++17 -O2 -I.. LatencyBench.cpp -o LatencyBench
+// Run:   ./LatencyBench [pairs = 4000000]
+// Every operation is timed on its own. Prints percentiles and the maximum in ns for:
+//   grow   inserting pairs keys into an empty map,
+//   churn  erasing a random key and inserting a new one, pairs times, on the map filled to
+//          CHURN_LOAD_FACTOR, which fills the table with tombstones again and again,
+//   shrink erasing all keys, one by one.
+//
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../HashMap.hpp"
+
+#define CHURN_LOAD_FACTOR 0.74
+
+static volatile size_t sink;
+
+/**
+ * @return nanoseconds since some fixed point.
+ */
+static uint64_t nowNs()
+{
+    return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Prints percentiles of operation latencies.
+ * @param name printed name of the workload.
+ * @param latencies ns each operation took, sorted in place.
+ */
+static void report(const char *name, std::vector<uint64_t> &latencies)
+{
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << "  " << name;
+    for (double percentile: {50.0, 99.0, 99.9, 99.99})
+    {
+        std::cout << "\t" << latencies[(size_t) ((double) latencies.size() * percentile / 100)];
+    }
+    std::cout << "\t" << latencies.back() << std::endl;
+}
+
+/**
+ * @brief Runs the three workloads on one rehashing mode.
+ * @param incremental true to rehash incrementally.
+ * @param pairs number of keys to insert.
+ */
+static void run(bool incremental, size_t pairs)
+{
+    // Random 64-bit keys, distinct but for a negligible chance.
+    std::mt19937_64 random(42);
+    std::vector<uint64_t> latencies(pairs), live;
+    HashMap<uint64_t, uint64_t> map;
+    map.setIncrementalRehash(incremental);
+    std::cout << (incremental ? "incremental" : "default") << ":" << std::endl;
+
+    for (size_t i = 0; i < pairs; i++)
+    {
+        live.push_back(random());
+        uint64_t start = nowNs();
+        map.insert(live.back(), i);
+        latencies[i] = nowNs() - start;
+    }
+    report("grow", latencies);
+
+    // Filled close to growing, erasures leave tombstones faster than insertions reuse them.
+    while ((double) (map.size() + 1) / map.capacity() < CHURN_LOAD_FACTOR)
+    {
+        live.push_back(random());
+        map.insert(live.back(), 0);
+    }
+    for (size_t i = 0; i < pairs; i++)
+    {
+        uint64_t &victim = live[random() % live.size()], key = random();
+        uint64_t start = nowNs();
+        map.erase(victim);
+        map.insert(key, i);
+        latencies[i] = nowNs() - start;
+        victim = key;
+    }
+    report("churn", latencies);
+
+    latencies.resize(live.size());
+    for (size_t i = 0; i < live.size(); i++)
+    {
+        uint64_t start = nowNs();
+        map.erase(live[i]);
+        latencies[i] = nowNs() - start;
+    }
+    report("shrink", latencies);
+    sink = map.size();
+}
+
+int main(int argc, char *argv[])
+{
+    size_t pairs = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    std::cout << pairs << " pairs, ns per operation" << std::endl;
+    std::cout << "  \tp50\tp99\tp99.9\tp99.99\tmax" << std::endl;
+    run(false, pairs);
+    run(true, pairs);
+    return 0;
+}
@@ -0,0 +1,108 @@
+//
+// Benchmark: the flat open addressing HashMap against the original vector-per-bucket
+// layout, kept in ChainedHashMap.hpp, on int and std::string keys.
+// Build: g++ -std=c++17 -O2 -I.. LayoutBench.cpp -o LayoutBench
+// Run:   ./LayoutBench [pairs = 4000000]
+// Prints ns per operation for both layouts, the best of REPEATS runs.
+//
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../HashMap.hpp"
+#include "ChainedHashMap.hpp"
+
+#define REPEATS 3
+
+static volatile size_t sink;
+
+/**
+ * @return seconds since some fixed point.
+ */
+static double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Times the operations of one layout on a set of keys.
+ * @param name printed name of the layout.
+ * @param keys keys to insert, look for and erase.
+ * @param misses keys missing from the map.
+ */
+template<class Map, class KeyT>
+static void run(const char *name, const std::vector<KeyT> &keys, const std::vector<KeyT> &misses)
+{
+    double best[5] = {1e30, 1e30, 1e30, 1e30, 1e30};
+    for (int repeat = 0; repeat < REPEATS; repeat++)
+    {
+        Map map;
+        double start = now();
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            map.insert(keys[i], (int) i);
+        }
+        double inserted = now();
+        size_t sum = 0;
+        for (const KeyT &key: keys)
+        {
+            sum += (size_t) map.at(key);
+        }
+        double found = now();
+        for (const KeyT &key: misses)
+        {
+            sum += map.containsKey(key);
+        }
+        double missed = now();
+        for (const auto &pair: map)
+        {
+            sum += (size_t) pair.second;
+        }
+        double iterated = now();
+        for (const KeyT &key: keys)
+        {
+            sum += map.erase(key);
+        }
+        double erased = now();
+        sink = sum;
+        double times[5] = {inserted - start, found - inserted, missed - found, iterated - missed, erased - iterated};
+        for (int i = 0; i < 5; i++)
+        {
+            best[i] = std::min(best[i], times[i]);
+        }
+    }
+    double n = (double) keys.size();
+    std::cout << "  " << name << "\tinsert " << best[0] * 1e9 / n << "\tat " << best[1] * 1e9 / n
+              << "\tmiss " << best[2] * 1e9 / (double) misses.size() << "\titerate " << best[3] * 1e9 / n
+              << "\terase " << best[4] * 1e9 / n << " ns/op" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t numOfPairs = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    std::mt19937_64 random(42);
+    std::vector<int> intKeys, intMisses;
+    std::vector<std::string> stringKeys, stringMisses;
+    for (size_t i = 0; i < numOfPairs; i++)
+    {
+        // Odd keys are stored and even keys missed, so the two sets never meet.
+        intKeys.push_back((int) (random() & 0x7FFFFFFF) | 1);
+        intMisses.push_back((int) (random() & 0x7FFFFFFF) & ~1);
+        stringKeys.push_back("key:" + std::to_string(random()) + "+");
+        stringMisses.push_back("key:" + std::to_string(random()) + "-");
+    }
+    std::sort(intKeys.begin(), intKeys.end());
+    intKeys.erase(std::unique(intKeys.begin(), intKeys.end()), intKeys.end());
+    std::shuffle(intKeys.begin(), intKeys.end(), random);
+
+    std::cout << intKeys.size() << " int keys:" << std::endl;
+    run<ChainedHashMap<int, int>>("chained", intKeys, intMisses);
+    run<HashMap<int, int>>("flat", intKeys, intMisses);
+    std::cout << stringKeys.size() << " std::string keys:" << std::endl;
+    run<ChainedHashMap<std::string, int>>("chained", stringKeys, stringMisses);
+    run<HashMap<std::string, int>>("flat", stringKeys, stringMisses);
+    return 0;
+}
@@ -0,0 +1,142 @@
+//
+// Benchmark: SpamDetector on one large message, spam-heavy and ham-heavy, to see how much
+// stopping at the threshold saves and what scanning to the end costs.
+// Build: g++ -std=c++17 -O2 -I.. LimitBench.cpp -o LimitBench
+// Run:   ./LimitBench <SpamDetector binary> [baseline binary] [message MB = 110]
+// Writes a database of EXPRESSIONS expressions, one in ZERO_EVERY of weight 0, and two
+// messages of random words to a temporary directory:
+//   spam  one word in SPAM_EVERY a weighted expression, so threshold SPAM_THRESHOLD is
+//         reached within the first kilobytes,
+//   ham   words of digits and one in SPAM_EVERY a zero-weight expression, so no
+//         threshold is reached.
+// Prints seconds per run of the binary, and of the baseline, such as a build from before
+// the threshold stopped the scan, on the same files.
+//
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#define EXPRESSIONS 1000
+
+#define ZERO_EVERY 10
+
+#define SPAM_EVERY 20
+
+#define SPAM_THRESHOLD "5"
+
+#define MB (1 << 20)
+
+/**
+ * @return seconds since some fixed point.
+ */
+static double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @param random generator to draw from.
+ * @param first first char words are made of.
+ * @param letters number of chars, from first on, words are made of.
+ * @return random word of 3 to 10 such chars.
+ */
+static std::string randomWord(std::mt19937_64 &random, char first, int letters)
+{
+    std::string word(3 + random() % 8, first);
+    for (char &c: word)
+    {
+        c = (char) (first + random() % letters);
+    }
+    return word;
+}
+
+/**
+ * @brief Runs a shell command with its output thrown away.
+ * @param command command to run.
+ * @return seconds the command took.
+ */
+static double timeCommand(const std::string &command)
+{
+    double start = now();
+    if (std::system((command + " > /dev/null").c_str()) != 0)
+    {
+        std::cerr << "failed: " << command << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+    return now() - start;
+}
+
+/**
+ * @brief Writes a message of random words, some of them expressions.
+ * @param path file to write.
+ * @param bytes size of the message.
+ * @param expressions expressions to mix in.
+ * @param every one word in every is an expression.
+ * @param first first char the other words are made of.
+ * @param letters number of chars, from first on, the other words are made of.
+ * @param random generator to draw from.
+ */
+static void writeMessage(const std::filesystem::path &path, size_t bytes, const std::vector<std::string> &expressions,
+                         int every, char first, int letters, std::mt19937_64 &random)
+{
+    std::string message;
+    while (message.size() < bytes)
+    {
+        message += random() % every == 0 ? expressions[random() % expressions.size()] :
+                   randomWord(random, first, letters);
+        message += ' ';
+    }
+    std::ofstream(path) << message;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: LimitBench <SpamDetector binary> [baseline binary] [message MB]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::vector<std::string> binaries{std::filesystem::absolute(argv[1]).string()};
+    if (argc > 2)
+    {
+        binaries.push_back(std::filesystem::absolute(argv[2]).string());
+    }
+    size_t bytes = (argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 110) * MB;
+    std::filesystem::path directory = std::filesystem::temp_directory_path() /
+                                      ("LimitBench." + std::to_string(getpid()));
+    std::filesystem::create_directories(directory);
+    std::filesystem::path database = directory / "database.csv";
+
+    std::mt19937_64 random(42);
+    std::vector<std::string> weighted, zero;
+    std::ofstream databaseFile(database);
+    for (int i = 0; i < EXPRESSIONS; i++)
+    {
+        // Weighted expressions are made of a to m, zero-weight ones of n to z, so no
+        // weighted expression hides in the ham message.
+        bool isZero = i % ZERO_EVERY == 0;
+        std::string expression = randomWord(random, isZero ? 'n' : 'a', 13);
+        (isZero ? zero : weighted).push_back(expression);
+        databaseFile << expression << "," << (isZero ? 0 : 1 + random() % 9) << "\n";
+    }
+    databaseFile.close();
+    writeMessage(directory / "spam.txt", bytes, weighted, SPAM_EVERY, 'a', 26, random);
+    writeMessage(directory / "ham.txt", bytes, zero, SPAM_EVERY, '0', 10, random);
+
+    std::cout << bytes / MB << " MB messages, seconds per run" << std::endl;
+    std::cout << "binary\tspam, threshold " SPAM_THRESHOLD "\tham" << std::endl;
+    for (const std::string &binary: binaries)
+    {
+        std::string command = "'" + binary + "' '" + database.string() + "' '" + directory.string();
+        std::cout << binary << "\t" << timeCommand(command + "/spam.txt' " SPAM_THRESHOLD) << "\t"
+                  << timeCommand(command + "/ham.txt' " SPAM_THRESHOLD) << std::endl;
+    }
+    std::filesystem::remove_all(directory);
+    return 0;
+}
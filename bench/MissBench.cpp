@@ -0,0 +1,110 @@
+//
+// Benchmark: lookups of which half miss, on the flat HashMap and on the original layout,
+// kept in ChainedHashMap.hpp, whose operator[] finds misses by catching the exception at()
+// throws.
+// Build: g++ -std=c++17 -O2 -I.. MissBench.cpp -o MissBench
+// Run:   ./MissBench [pairs = 1000000]
+// Prints ns per lookup, the best of REPEATS runs, for:
+//   const []       value or a default through the const operator[],
+//   contains + at  containsKey, then at on a hit,
+//   find           find, then the value on a hit (flat only),
+//   []++           operator[] incrementing the value, inserting on a miss.
+//
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../HashMap.hpp"
+#include "ChainedHashMap.hpp"
+
+#define REPEATS 3
+
+static volatile long sink;
+
+/**
+ * @return seconds since some fixed point.
+ */
+static double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Times one way of looking up the queries, on a fresh map every run.
+ * @param name printed name.
+ * @param keys keys the map holds.
+ * @param queries half keys, half missing keys, shuffled.
+ * @param lookup looks up one query in the map, returns a value to sum.
+ */
+template<class Map, class Lookup>
+static void run(const char *name, const std::vector<std::string> &keys, const std::vector<std::string> &queries,
+                Lookup lookup)
+{
+    double best = 1e30;
+    for (int repeat = 0; repeat < REPEATS; repeat++)
+    {
+        Map map;
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            map.insert(keys[i], (int) i);
+        }
+        long sum = 0;
+        double start = now();
+        for (const std::string &query: queries)
+        {
+            sum += lookup(map, query);
+        }
+        best = std::min(best, now() - start);
+        sink = sum;
+    }
+    std::cout << "  " << name << "\t" << best * 1e9 / (double) queries.size() << " ns/lookup" << std::endl;
+}
+
+/**
+ * @brief Times every way of looking up on one layout.
+ */
+template<class Map>
+static void runAll(const char *layout, const std::vector<std::string> &keys, const std::vector<std::string> &queries)
+{
+    std::cout << layout << ":" << std::endl;
+    run<Map>("const []", keys, queries, [](Map &map, const std::string &query)
+    {
+        return (long) static_cast<const Map &>(map)[query];
+    });
+    run<Map>("contains + at", keys, queries, [](Map &map, const std::string &query)
+    {
+        return map.containsKey(query) ? (long) map.at(query) : 0L;
+    });
+    run<Map>("[]++", keys, queries, [](Map &map, const std::string &query)
+    {
+        return (long) ++map[query];
+    });
+}
+
+int main(int argc, char *argv[])
+{
+    size_t numOfPairs = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    std::mt19937_64 random(42);
+    std::vector<std::string> keys, queries;
+    for (size_t i = 0; i < numOfPairs; i++)
+    {
+        keys.push_back("word:" + std::to_string(random()));
+        queries.push_back(keys.back());
+        queries.push_back("miss:" + std::to_string(random()));
+    }
+    std::shuffle(queries.begin(), queries.end(), random);
+    std::cout << numOfPairs << " pairs, " << queries.size() << " lookups, 50% misses" << std::endl;
+
+    runAll<ChainedHashMap<std::string, int>>("chained", keys, queries);
+    runAll<HashMap<std::string, int>>("flat", keys, queries);
+    run<HashMap<std::string, int>>("find", keys, queries, [](HashMap<std::string, int> &map,
+                                                             const std::string &query)
+    {
+        auto found = map.find(query);
+        return found == map.end() ? 0L : (long) found->second;
+    });
+    return 0;
+}
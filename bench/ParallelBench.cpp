@@ -0,0 +1,143 @@
+//
+// Benchmark: parallel rehash and parallel construction of HashMap from 1 to MAX_THREADS
+// threads, on several sizes, and what starting the threads costs on its own.
+// Build: g++ -std=c++17 -O2 -pthread -I.. ParallelBench.cpp -o ParallelBench
+// Run:   ./ParallelBench [largest pairs = 4194304]
+// Prints ms, the best of REPEATS runs, for:
+//   start   starting and joining threads - 1 threads that do nothing,
+//   rehash  reserve() doubling the capacity of a map holding pairs pairs,
+//   build   HashMap(keys, values, threads) of pairs pairs.
+// Setting threads only enables the parallel path, the HashMap may use fewer threads on
+// small tables.
+//
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+#include "../HashMap.hpp"
+
+#define MAX_THREADS 8
+
+#define MIN_PAIRS (1 << 12)
+
+#define REPEATS 3
+
+#define START_ROUNDS 100
+
+static volatile size_t sink;
+
+/**
+ * @return seconds since some fixed point.
+ */
+static double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @param threads number of threads working, the calling thread included.
+ * @return ms to start and join threads - 1 threads doing nothing.
+ */
+static double startThreads(unsigned int threads)
+{
+    double start = now();
+    for (int round = 0; round < START_ROUNDS; round++)
+    {
+        std::vector<std::thread> workers;
+        for (unsigned int t = 1; t < threads; t++)
+        {
+            workers.emplace_back([]()
+                                 {});
+        }
+        for (std::thread &worker: workers)
+        {
+            worker.join();
+        }
+    }
+    return (now() - start) * 1e3 / START_ROUNDS;
+}
+
+/**
+ * @param map map to copy and rehash.
+ * @param threads number of threads rehashing.
+ * @return ms to double the capacity of a copy of map.
+ */
+static double rehash(const HashMap<uint64_t, uint64_t> &map, unsigned int threads)
+{
+    double best = 1e30;
+    for (int repeat = 0; repeat < REPEATS; repeat++)
+    {
+        HashMap<uint64_t, uint64_t> copy(map);
+        copy.setParallelRehash(threads);
+        double start = now();
+        copy.reserve(copy.capacity());
+        best = std::min(best, now() - start);
+        sink = copy.capacity();
+    }
+    return best * 1e3;
+}
+
+/**
+ * @param keys keys of the map.
+ * @param values values of the map.
+ * @param threads number of threads building.
+ * @return ms to build a map from keys and values.
+ */
+static double build(const std::vector<uint64_t> &keys, const std::vector<uint64_t> &values, unsigned int threads)
+{
+    double best = 1e30;
+    for (int repeat = 0; repeat < REPEATS; repeat++)
+    {
+        double start = now();
+        HashMap<uint64_t, uint64_t> map(keys, values, threads);
+        best = std::min(best, now() - start);
+        sink = map.size();
+    }
+    return best * 1e3;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t largest = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (size_t) 1 << 22;
+    std::cout << std::thread::hardware_concurrency() << " hardware threads, ms" << std::endl;
+    std::cout << "threads";
+    for (unsigned int threads = 1; threads <= MAX_THREADS; threads *= 2)
+    {
+        std::cout << "\t" << threads;
+    }
+    std::cout << std::endl << "start";
+    for (unsigned int threads = 1; threads <= MAX_THREADS; threads *= 2)
+    {
+        std::cout << "\t" << startThreads(threads);
+    }
+    std::cout << std::endl;
+
+    std::mt19937_64 random(42);
+    for (size_t pairs = MIN_PAIRS; pairs <= largest; pairs *= 4)
+    {
+        std::vector<uint64_t> keys(pairs), values(pairs);
+        HashMap<uint64_t, uint64_t> map;
+        for (size_t i = 0; i < pairs; i++)
+        {
+            keys[i] = random();
+            values[i] = i;
+            map.insert(keys[i], values[i]);
+        }
+        std::cout << "rehash " << pairs;
+        for (unsigned int threads = 1; threads <= MAX_THREADS; threads *= 2)
+        {
+            std::cout << "\t" << rehash(map, threads);
+        }
+        std::cout << std::endl << "build " << pairs;
+        for (unsigned int threads = 1; threads <= MAX_THREADS; threads *= 2)
+        {
+            std::cout << "\t" << build(keys, values, threads);
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
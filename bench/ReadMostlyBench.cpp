@@ -0,0 +1,148 @@
+//
+// Benchmark: lookups on ReadMostlyHashMap against one HashMap behind a std::shared_mutex,
+// from 1 to 64 reader threads, while a writer reloads the whole map every RELOAD_MS.
+// Build: g++ -std=c++17 -O2 -pthread -I.. ReadMostlyBench.cpp -o ReadMostlyBench
+// Run:   ./ReadMostlyBench [lookups = 8000000] [keys = 1000000]
+// The lookups are split between the readers. Prints millions of lookups per second.
+//
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+#include "../ReadMostlyHashMap.hpp"
+
+#define MAX_THREADS 64
+
+#define RELOAD_MS 100
+
+typedef HashMap<uint64_t, uint64_t> tableType;
+
+static std::atomic<uint64_t> sink(0);
+
+/**
+ * @brief One HashMap behind one reader-writer lock, the way the maps were shared before.
+ */
+class LockedHashMap
+{
+private:
+    mutable std::shared_mutex lock;
+    tableType map;
+
+public:
+    bool find(uint64_t key, uint64_t &val) const
+    {
+        std::shared_lock<std::shared_mutex> guard(lock);
+        auto found = map.find(key);
+        if (found == map.end())
+        {
+            return false;
+        }
+        val = found->second;
+        return true;
+    }
+
+    void reload(tableType &&table)
+    {
+        std::unique_lock<std::shared_mutex> guard(lock);
+        map = std::move(table);
+    }
+};
+
+/**
+ * @return seconds since some fixed point.
+ */
+static double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @param keys keys of the table.
+ * @return table mapping every key to 1.
+ */
+static tableType makeTable(const std::vector<uint64_t> &keys)
+{
+    tableType table;
+    table.reserve(keys.size());
+    for (uint64_t key: keys)
+    {
+        table.insert(key, 1);
+    }
+    return table;
+}
+
+/**
+ * @brief Runs lookups split between reader threads while one writer reloads the map.
+ * @param threads number of readers.
+ * @param lookups total number of lookups.
+ * @param keys keys of the map.
+ * @param table copy of the map's table, reloaded again and again.
+ * @return millions of lookups per second.
+ */
+template<class Map>
+static double run(int threads, size_t lookups, const std::vector<uint64_t> &keys, const tableType &table)
+{
+    Map map;
+    map.reload(tableType(table));
+    std::atomic<bool> done(false);
+    std::thread writer([&map, &table, &done]()
+                       {
+                           while (!done.load())
+                           {
+                               std::this_thread::sleep_for(std::chrono::milliseconds(RELOAD_MS));
+                               map.reload(tableType(table));
+                           }
+                       });
+    std::vector<std::thread> readers;
+    double start = now();
+    for (int t = 0; t < threads; t++)
+    {
+        readers.emplace_back([&map, &keys, t, threads, lookups]()
+                             {
+                                 std::mt19937_64 random((uint64_t) t + 1);
+                                 uint64_t sum = 0;
+                                 for (size_t i = t; i < lookups; i += threads)
+                                 {
+                                     uint64_t value = 0;
+                                     map.find(keys[random() % keys.size()], value);
+                                     sum += value;
+                                 }
+                                 sink += sum;
+                             });
+    }
+    for (std::thread &reader: readers)
+    {
+        reader.join();
+    }
+    double seconds = now() - start;
+    done = true;
+    writer.join();
+    return (double) lookups / seconds / 1e6;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t lookups = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 8000000;
+    size_t numOfKeys = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+    std::mt19937_64 random(42);
+    std::vector<uint64_t> keys(numOfKeys);
+    for (uint64_t &key: keys)
+    {
+        key = random();
+    }
+    tableType table = makeTable(keys);
+    std::cout << std::thread::hardware_concurrency() << " hardware threads, " << lookups << " lookups on "
+              << numOfKeys << " keys, a reload every " << RELOAD_MS << " ms, Mlookups/s" << std::endl;
+    std::cout << "readers\tshared_mutex\tread-mostly" << std::endl;
+    for (int threads = 1; threads <= MAX_THREADS; threads *= 2)
+    {
+        std::cout << threads << "\t" << run<LockedHashMap>(threads, lookups, keys, table) << "\t"
+                  << run<ReadMostlyHashMap<uint64_t, uint64_t>>(threads, lookups, keys, table) << std::endl;
+    }
+    return 0;
+}
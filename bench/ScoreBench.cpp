@@ -0,0 +1,137 @@
+//
+// Benchmark: scoring a message against an expression database with the AhoCorasick
+// automaton SpamDetector builds, against the std::string::find loop it replaced.
+// Build: g++ -std=c++17 -O2 -I.. ScoreBench.cpp -o ScoreBench
+// Run:   ./ScoreBench [expressions = 200000] [message bytes = 20480]
+// Expressions are random lowercase words of MIN_LENGTH to MAX_LENGTH letters, the message
+// random lowercase words, one in MATCH_EVERY of them an expression. Prints the number of
+// automaton states, the time to build it, and the time to score the message both ways,
+// the best of REPEATS runs.
+//
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include "../AhoCorasick.hpp"
+#include "../OrderedHashMap.hpp"
+
+#define MIN_LENGTH 4
+
+#define MAX_LENGTH 20
+
+#define MAX_WEIGHT 9
+
+#define MATCH_EVERY 8
+
+#define SCANS 100
+
+#define REPEATS 3
+
+static volatile long long sink;
+
+/**
+ * @return seconds since some fixed point.
+ */
+static double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @param random generator to draw from.
+ * @return random lowercase word of MIN_LENGTH to MAX_LENGTH letters.
+ */
+static std::string randomWord(std::mt19937_64 &random)
+{
+    std::string word(MIN_LENGTH + random() % (MAX_LENGTH - MIN_LENGTH + 1), 'a');
+    for (char &c: word)
+    {
+        c = (char) ('a' + random() % 26);
+    }
+    return word;
+}
+
+/**
+ * @brief The scoring loop SpamDetector::detect ran before the automaton: every occurrence
+ * of every expression found with std::string::find.
+ * @param database expressions and their weights.
+ * @param message lowercase message.
+ * @return sum of the weights of all the occurrences of expressions in message.
+ */
+static long long findLoop(const OrderedHashMap<std::string, int> &database, const std::string &message)
+{
+    long long score = 0;
+    for (const auto &pair: database)
+    {
+        size_t index = message.find(pair.first);
+        while (index != std::string::npos)
+        {
+            score += pair.second;
+            index = message.find(pair.first, index + 1);
+        }
+    }
+    return score;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t numOfExpressions = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    size_t messageBytes = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20480;
+    std::mt19937_64 random(42);
+    OrderedHashMap<std::string, int> database;
+    std::vector<std::string> expressions;
+    while (expressions.size() < numOfExpressions)
+    {
+        std::string word = randomWord(random);
+        if (!database.containsKey(word))
+        {
+            database.insert(word, (int) (1 + random() % MAX_WEIGHT));
+            expressions.push_back(word);
+        }
+    }
+    std::string message;
+    while (message.size() < messageBytes)
+    {
+        message += random() % MATCH_EVERY == 0 ? expressions[random() % expressions.size()] : randomWord(random);
+        message += ' ';
+    }
+    message.resize(messageBytes);
+
+    double build = 1e30;
+    for (int repeat = 0; repeat < REPEATS; repeat++)
+    {
+        double start = now();
+        AhoCorasick matcher(database, true);
+        build = std::min(build, now() - start);
+        sink = (long long) matcher.numOfStates();
+    }
+    AhoCorasick matcher(database, true);
+    double automaton = 1e30;
+    long long score = 0;
+    for (int repeat = 0; repeat < REPEATS; repeat++)
+    {
+        double start = now();
+        for (int scan = 0; scan < SCANS; scan++)
+        {
+            score = matcher.score(message);
+        }
+        automaton = std::min(automaton, (now() - start) / SCANS);
+    }
+    // The find loop takes seconds, one run is enough.
+    double start = now();
+    long long expected = findLoop(database, message);
+    double loop = now() - start;
+    if (score != expected)
+    {
+        std::cerr << "scores differ: " << score << " and " << expected << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << numOfExpressions << " expressions, " << matcher.numOfStates() << " states, " << messageBytes
+              << " byte message scoring " << score << std::endl;
+    std::cout << "build\t" << build << " s" << std::endl;
+    std::cout << "automaton\t" << automaton * 1e3 << " ms per message" << std::endl;
+    std::cout << "find loop\t" << loop * 1e3 << " ms per message" << std::endl;
+    return 0;
+}
@@ -0,0 +1,43 @@
+//
+// Regression test: the constructors from key and value vectors, serial and parallel, leave
+// their map to the destructor alone when they throw, so an Arena-backed map isn't released
+// twice.
+// Build and run: g++ -std=c++17 -I.. ConstructorThrowTest.cpp -o ConstructorThrowTest && ./ConstructorThrowTest
+//
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include "../ArenaAllocator.hpp"
+#include "../HashMap.hpp"
+
+typedef HashMap<int, int, std::hash<int>, std::equal_to<int>, ArenaAllocator<std::pair<int, int>>> arenaMap;
+
+int main()
+{
+    Arena arena;
+    ArenaAllocator<std::pair<int, int>> allocator(arena);
+    std::vector<int> keys(100, 1), values(99, 1);
+    for (unsigned int threads: {0u, 4u})
+    {
+        bool thrown = false;
+        try
+        {
+            if (threads == 0)
+            {
+                arenaMap map(keys, values, allocator);
+            }
+            else
+            {
+                arenaMap map(keys, values, threads, allocator);
+            }
+        }
+        catch (const std::runtime_error &)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    std::cout << "ConstructorThrowTest passed" << std::endl;
+    return 0;
+}
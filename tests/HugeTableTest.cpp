@@ -0,0 +1,81 @@
+//
+// Stress test: a HashMap of compact keys holding more than 2^31 pairs in more than 2^31
+// slots, so sizes, capacities, slot indices and iterator positions all pass the int range.
+// Without arguments it runs the same checks on a small table. The full run is opt-in: it
+// needs about 70 GB of memory and several minutes.
+// Build: g++ -std=c++17 -O2 -I.. HugeTableTest.cpp -o HugeTableTest
+// Run:   ./HugeTableTest [--huge]
+//
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include "../HashMap.hpp"
+
+#define HUGE_FLAG "--huge"
+
+#define HUGE_PAIRS (((size_t) 1 << 31) + ((size_t) 1 << 20))
+
+#define SMALL_PAIRS ((size_t) 1 << 20)
+
+#define SAMPLES 1000000
+
+typedef HashMap<uint32_t, uint8_t> compactMap;
+
+int main(int argc, char *argv[])
+{
+    bool huge = argc > 1 && std::strcmp(argv[1], HUGE_FLAG) == 0;
+    size_t pairs = huge ? HUGE_PAIRS : SMALL_PAIRS;
+    compactMap map;
+    map.reserve(pairs);
+    size_t slotBytes = sizeof(std::pair<uint32_t, uint8_t>) + sizeof(size_t) + 1;
+    std::cout << pairs << " pairs in " << map.capacity() << " slots, about "
+              << (map.capacity() * slotBytes >> 20) << " MB" << std::endl;
+    assert(!huge || map.capacity() > ((size_t) 1 << 31));
+
+    for (size_t i = 0; i < pairs; i++)
+    {
+        map.insert((uint32_t) i, (uint8_t) i);
+    }
+    assert(map.size() == pairs);
+    assert(!huge || map.size() > ((size_t) 1 << 31));
+
+    // Keys spread over every slot, so the homes of some pass 2^31 in the huge table.
+    size_t step = pairs / SAMPLES, highestIndex = 0;
+    for (size_t i = 0; i < pairs; i += step)
+    {
+        auto found = map.find((uint32_t) i);
+        assert(found != map.end() && found->second == (uint8_t) i);
+        highestIndex = std::max(highestIndex, (size_t) map.bucketIndex((uint32_t) i));
+    }
+    assert(highestIndex >= map.capacity() / 2);
+    assert(!map.containsKey((uint32_t) pairs));
+
+    size_t visited = 0, sum = 0;
+    for (const auto &pair: map)
+    {
+        visited++;
+        sum += pair.second;
+    }
+    assert(visited == pairs);
+    size_t expected = 0;
+    for (size_t i = 0; i < pairs; i++)
+    {
+        expected += (uint8_t) i;
+    }
+    assert(sum == expected);
+
+    size_t erased = 0;
+    for (size_t i = 0; i < pairs; i += step)
+    {
+        erased += map.erase((uint32_t) i);
+    }
+    assert(map.size() == pairs - erased);
+    for (size_t i = 0; i < pairs; i += step)
+    {
+        assert(!map.containsKey((uint32_t) i));
+        assert(map.containsKey((uint32_t) (i + 1)) == (i + 1 < pairs && (i + 1) % step != 0));
+    }
+    std::cout << "HugeTableTest passed" << std::endl;
+    return 0;
+}
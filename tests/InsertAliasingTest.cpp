@@ -0,0 +1,144 @@
+//
+// Regression test: inserting arguments that refer into the map itself, right at the
+// point where the insertion has to grow the table, move pairs or clean tombstones.
+// Build and run: g++ -std=c++17 -I.. InsertAliasingTest.cpp -o InsertAliasingTest && ./InsertAliasingTest
+//
+#include <cassert>
+#include <iostream>
+#include <string>
+#include "../HashMap.hpp"
+
+/**
+ * @param i number of a value.
+ * @return a 50 char value, too long for the small string buffer.
+ */
+static std::string longValue(int i)
+{
+    return std::string(48, (char) ('a' + i % 26)) + std::to_string(i % 10) + "!";
+}
+
+/**
+ * @brief Inserts pairs made by make(n), n = size(), until the table holds at least 16
+ * slots and the next insertion has to grow it.
+ * @param m map to fill.
+ * @param make makes the pair number n.
+ */
+template<class Map, class Make>
+static void fillToGrowth(Map &m, Make make)
+{
+    while (m.capacity() < 16 || (double) (m.size() + 1) / m.capacity() <= 0.75)
+    {
+        auto pair = make((int) m.size());
+        m.insert(pair.first, pair.second);
+    }
+}
+
+/**
+ * @brief Fills a map until the next insertion has to grow it, then inserts with aliased
+ * arguments through every insertion path.
+ * @param incremental whether the map rehashes incrementally.
+ */
+static void testIntKeys(bool incremental)
+{
+    for (int path = 0; path < 2; path++)
+    {
+        HashMap<int, std::string> m;
+        m.setIncrementalRehash(incremental);
+        fillToGrowth(m, [](int n)
+        { return std::make_pair(n, longValue(n)); });
+        size_t capacity = m.capacity();
+        std::string expected = m.at(0);
+        if (path == 0)
+        {
+            assert(m.insert(1000, m.at(0)));
+        }
+        else
+        {
+            assert(m.try_emplace(1000, m.at(0)));
+        }
+        assert(m.capacity() > capacity || incremental);
+        assert(m.at(1000) == expected);
+        assert(m.at(0) == expected);
+    }
+}
+
+/**
+ * @brief Same with string keys taken from the map's values.
+ * @param incremental whether the map rehashes incrementally.
+ */
+static void testStringKeys(bool incremental)
+{
+    HashMap<std::string, std::string> m;
+    m.setIncrementalRehash(incremental);
+    auto make = [](int n)
+    { return std::make_pair("k" + std::to_string(n), longValue(n)); };
+    fillToGrowth(m, make);
+    int n = (int) m.size();
+    std::string key = m.at("k3");
+    assert(m.insert(m.at("k3"), "x"));
+    assert(m.containsKey(key));
+    assert(!m.containsKey(""));
+    assert(m.at(key) == "x");
+
+    // operator[] with a key read from the map, growing again.
+    fillToGrowth(m, make);
+    key = m.at("k5");
+    m[m.at("k5")] = "y";
+    assert(m.at(key) == "y");
+
+    // Keep inserting through the whole migration, every key aliasing a value in the map.
+    for (int i = 0; i < 200; i++)
+    {
+        std::string source = "k" + std::to_string(i % n);
+        std::string value = m.at(source);
+        m.try_emplace("copy" + std::to_string(i), m.at(source));
+        assert(m.at("copy" + std::to_string(i)) == value);
+    }
+}
+
+/**
+ * @brief Growing out of the inline table.
+ */
+static void testInlineGrowth()
+{
+    HashMap<int, std::string> m;
+    for (int i = 0; i < 4 && (double) (m.size() + 1) / m.capacity() <= 0.75; i++)
+    {
+        m.insert(i, longValue(i));
+    }
+    assert(m.insert(4, m.at(1)));
+    assert(m.at(4) == longValue(1));
+}
+
+/**
+ * @brief An insertion that cleans tombstones with an in place rehash.
+ */
+static void testTombstoneCleanup()
+{
+    HashMap<int, std::string> m;
+    m.setLoadFactors(0.75, 0);
+    m.reserve(96);
+    for (int round = 0; round < 2000; round++)
+    {
+        m.insert(round, longValue(round));
+        if (m.size() > 60)
+        {
+            assert(m.erase(round - 60));
+        }
+        assert(m.insert(-1 - round, m.at(round)));
+        assert(m.at(-1 - round) == longValue(round));
+        assert(m.erase(-1 - round));
+    }
+}
+
+int main()
+{
+    testIntKeys(false);
+    testIntKeys(true);
+    testStringKeys(false);
+    testStringKeys(true);
+    testInlineGrowth();
+    testTombstoneCleanup();
+    std::cout << "InsertAliasingTest passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,70 @@
+//
+// Regression test: an image whose std::string key records point past its end is refused
+// even when it is opened without its checksum, instead of read out of bounds by lookups.
+// Build and run: g++ -std=c++17 -I.. MappedCorruptTest.cpp -o MappedCorruptTest && ./MappedCorruptTest
+//
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include "../MappedHashMap.hpp"
+
+#define PAIRS 1000
+
+#define CORRUPT_SLOT 500
+
+/**
+ * @brief Saves an image, then overwrites one field of a key record in it.
+ * @param path image file to write.
+ * @param field 0 for the offset of the key's characters, 1 for their length.
+ * @param value written over the field.
+ */
+static void saveCorrupt(const std::string &path, int field, uint64_t value)
+{
+    HashMap<std::string, int> map;
+    for (int i = 0; i < PAIRS; i++)
+    {
+        map.insert("key" + std::to_string(i), i);
+    }
+    MappedHashMap<std::string, int>::save(map, path);
+    {
+        MappedHashMap<std::string, int> intact(path, false);
+        assert(intact.at("key7") == 7);
+    }
+    // The header is 14 fields of 64 bits, the slots offset is the 11th, and a slot starts
+    // with the key's offset and length.
+    uint64_t header[14];
+    FILE *file = std::fopen(path.c_str(), "r+b");
+    assert(file != nullptr);
+    size_t fields = std::fread(header, sizeof(uint64_t), 14, file);
+    assert(fields == 14);
+    size_t slotSize = (header[11] - header[10]) / PAIRS;
+    std::fseek(file, (long) (header[10] + CORRUPT_SLOT * slotSize + field * sizeof(uint64_t)), SEEK_SET);
+    std::fwrite(&value, sizeof(uint64_t), 1, file);
+    std::fclose(file);
+}
+
+int main()
+{
+    std::string path = "MappedCorruptTest." + std::to_string(getpid()) + ".img";
+    for (int field = 0; field < 2; field++)
+    {
+        // An offset past the end of the file, or a length reaching past it.
+        saveCorrupt(path, field, field == 0 ? 1ULL << 20 : 1ULL << 40);
+        bool refused = false;
+        try
+        {
+            MappedHashMap<std::string, int> corrupt(path, false);
+        }
+        catch (const std::invalid_argument &)
+        {
+            refused = true;
+        }
+        assert(refused);
+    }
+    unlink(path.c_str());
+    std::cout << "MappedCorruptTest passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,97 @@
+//
+// Regression test: saving an image over a file another MappedHashMap still maps. The old
+// mapping must keep reading the old image, not fault on a truncated file. Threads saving
+// over the same file at once must not share a temporary file.
+// Build and run: g++ -std=c++17 -pthread -I.. MappedResaveTest.cpp -o MappedResaveTest && ./MappedResaveTest
+//
+#include <cassert>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "../MappedHashMap.hpp"
+
+#define OLD_PAIRS 100000
+
+#define NEW_PAIRS 10
+
+#define SAVING_THREADS 8
+
+/**
+ * @param path image file to write.
+ * @param pairs number of pairs, key i maps to i * 3 + offset.
+ * @param offset added to every value.
+ */
+static void saveImage(const std::string &path, int pairs, int offset)
+{
+    HashMap<std::string, int> map;
+    for (int i = 0; i < pairs; i++)
+    {
+        map.insert("key" + std::to_string(i), i * 3 + offset);
+    }
+    MappedHashMap<std::string, int>::save(map, path);
+}
+
+int main()
+{
+    std::string path = "MappedResaveTest." + std::to_string(getpid()) + ".img";
+    saveImage(path, OLD_PAIRS, 0);
+    {
+        MappedHashMap<std::string, int> old(path);
+        assert(old.size() == OLD_PAIRS);
+        // The new image is much smaller, truncating in place would drop the pages old reads.
+        saveImage(path, NEW_PAIRS, 1);
+        for (int i = 0; i < OLD_PAIRS; i++)
+        {
+            assert(old.at("key" + std::to_string(i)) == i * 3);
+        }
+        MappedHashMap<std::string, int> current(path);
+        assert(current.size() == NEW_PAIRS);
+        for (int i = 0; i < NEW_PAIRS; i++)
+        {
+            assert(current.at("key" + std::to_string(i)) == i * 3 + 1);
+        }
+        assert(!current.containsKey("key" + std::to_string(NEW_PAIRS)));
+        // Saving again while both are mapped.
+        saveImage(path, OLD_PAIRS, 2);
+        assert(old.at("key99999") == 99999 * 3);
+        assert(current.at("key9") == 9 * 3 + 1);
+    }
+    MappedHashMap<std::string, int> last(path);
+    assert(last.size() == OLD_PAIRS && last.at("key5") == 17);
+    // Every thread saves a whole image, whichever is renamed last is the one left.
+    std::vector<std::thread> savers;
+    for (int t = 0; t < SAVING_THREADS; t++)
+    {
+        savers.emplace_back([&path, t]()
+                            {
+                                saveImage(path, OLD_PAIRS, t);
+                            });
+    }
+    for (std::thread &saver: savers)
+    {
+        saver.join();
+    }
+    MappedHashMap<std::string, int> raced(path);
+    int offset = raced.at("key0");
+    assert(raced.size() == OLD_PAIRS && offset < SAVING_THREADS && raced.at("key99999") == 99999 * 3 + offset);
+    for (const auto &entry: std::filesystem::directory_iterator("."))
+    {
+        assert(entry.path().filename().string().rfind(path + ".tmp.", 0) != 0);
+    }
+    bool failed = false;
+    try
+    {
+        saveImage("no_such_directory/image.img", 1, 0);
+    }
+    catch (const std::runtime_error &)
+    {
+        failed = true;
+    }
+    assert(failed);
+    unlink(path.c_str());
+    std::cout << "MappedResaveTest passed" << std::endl;
+    return 0;
+}
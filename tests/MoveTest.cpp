@@ -0,0 +1,63 @@
+//
+// Regression test: moving a HashMap doesn't throw, so std::vector moves HashMaps when it
+// grows instead of copying them, and move assignment between maps on different Arenas
+// moves the pairs into the target's Arena.
+// Build and run: g++ -std=c++17 -I.. MoveTest.cpp -o MoveTest && ./MoveTest
+//
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include "../ArenaAllocator.hpp"
+#include "../HashMap.hpp"
+
+typedef HashMap<std::string, std::string> stringMap;
+
+typedef HashMap<int, int, std::hash<int>, std::equal_to<int>, ArenaAllocator<std::pair<int, int>>> arenaMap;
+
+static_assert(std::is_nothrow_move_constructible<stringMap>::value, "std::allocator map must move without throwing");
+static_assert(std::is_nothrow_move_assignable<stringMap>::value, "std::allocator map must move without throwing");
+static_assert(std::is_nothrow_move_constructible<arenaMap>::value, "moving an allocator can't throw");
+static_assert(!std::is_nothrow_move_assignable<arenaMap>::value, "unequal Arenas need moving pairs one by one");
+
+int main()
+{
+    // Sizes on both sides of the inline table.
+    for (int pairs: {0, 3, 4, 5, 1000})
+    {
+        stringMap source, target;
+        for (int i = 0; i < pairs; i++)
+        {
+            source[std::to_string(i)] = std::string(32, (char) ('a' + i % 26));
+        }
+        target["stale"] = "pair";
+        target = std::move(source);
+        assert(target.size() == (size_t) pairs && source.empty());
+        for (int i = 0; i < pairs; i++)
+        {
+            assert(target.at(std::to_string(i)) == std::string(32, (char) ('a' + i % 26)));
+        }
+        assert(!target.containsKey("stale"));
+        source["reused"] = "ok";
+        assert(source.size() == 1);
+
+        Arena one, two;
+        arenaMap first{ArenaAllocator<std::pair<int, int>>(one)};
+        arenaMap second{ArenaAllocator<std::pair<int, int>>(two)};
+        for (int i = 0; i < pairs; i++)
+        {
+            first[i] = -i;
+        }
+        second[-1] = 1;
+        second = std::move(first);
+        assert(second.size() == (size_t) pairs && first.empty());
+        for (int i = 0; i < pairs; i++)
+        {
+            assert(second.at(i) == -i);
+        }
+        arenaMap third(std::move(second));
+        assert(third.size() == (size_t) pairs && second.empty());
+    }
+    std::cout << "MoveTest passed" << std::endl;
+    return 0;
+}